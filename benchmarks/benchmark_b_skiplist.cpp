@@ -0,0 +1,69 @@
+#include "../include/multithreaded_ds/concurrent_skiplist.hpp"
+#include "../include/multithreaded_ds/b_skiplist.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+// Skiplist<long> (one node per key) against BSkiplist<long> (fat nodes)
+// for random inserts and 1M random lookups, half of them hits. Key counts
+// are the arguments (default 1M and 10M). The block search follows the
+// build flags: -mavx2 for the AVX2 path, -msse4.2 for SSE, neither for the
+// scalar loop. At 100M keys Skiplist alone needs several GB; pass -b to
+// time only BSkiplist.
+
+template <typename F>
+double seconds(F body) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+template <typename List>
+void run(const char* name, const std::vector<long>& keys, const std::vector<long>& probes) {
+    List* list = new List();
+    double fill = seconds([&]() {
+        for (long k : keys) list->add(k);
+    });
+    size_t found = 0;
+    double lookup = seconds([&]() {
+        for (long k : probes) found += list->search(k);
+    });
+    double teardown = seconds([&]() { delete list; });
+    std::printf("%12zu %-10s %10.3f %10.3f %12.1f %10.3f %8zu\n", keys.size(), name, fill, lookup,
+                lookup * 1e9 / probes.size(), teardown, found);
+}
+
+int main(int argc, char** argv) {
+    bool only_fat = false;
+    std::vector<long> counts;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "-b") {
+            only_fat = true;
+        } else {
+            counts.push_back(std::atol(argv[i]));
+        }
+    }
+    if (counts.empty()) {
+        counts = {1000000, 10000000};
+    }
+
+    std::printf("%12s %-10s %10s %10s %12s %10s %8s\n", "keys", "list", "fill s", "lookup s", "ns/lookup", "free s", "hits");
+    for (long count : counts) {
+        std::mt19937_64 gen(42);
+        std::vector<long> keys(count);
+        for (long i = 0; i < count; ++i) keys[i] = i * 2;
+        std::shuffle(keys.begin(), keys.end(), gen);
+        std::vector<long> probes(1000000);
+        for (auto& p : probes) p = static_cast<long>(gen() % (2 * count));
+
+        if (!only_fat) {
+            run<multithreaded_ds::Skiplist<long>>("Skiplist", keys, probes);
+        }
+        run<multithreaded_ds::BSkiplist<long>>("BSkiplist", keys, probes);
+    }
+    return 0;
+}
@@ -0,0 +1,167 @@
+#include "../include/multithreaded_ds/flat_combining.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Where flat combining starts to beat plain locking: every thread runs
+// push/pop pairs (stack, queue) or add/search mixes (skiplist) against the
+// locked structure and its flat-combined wrapper. The stack is also run
+// against a lock-free Treiber stack.
+
+using multithreaded_ds::fc::op;
+
+constexpr int ops_per_thread = 100000;
+
+// Treiber stack for reference. Popped nodes are only freed after the run,
+// which rules out ABA without hazard pointers.
+class treiber_stack {
+public:
+    struct node {
+        int value;
+        node *next;
+    };
+
+    ~treiber_stack() {
+        node *cur = head.load();
+        while (cur) {
+            node *next = cur->next;
+            delete cur;
+            cur = next;
+        }
+    }
+
+    void push(int v) {
+        node *n = new node{v, head.load(std::memory_order_relaxed)};
+        while (!head.compare_exchange_weak(n->next, n, std::memory_order_release, std::memory_order_relaxed)) {}
+    }
+
+    // the popped node is handed to `graveyard` for the caller to free later
+    bool pop(int& v, std::vector<node*>& graveyard) {
+        node *n = head.load(std::memory_order_acquire);
+        while (n && !head.compare_exchange_weak(n, n->next, std::memory_order_acquire, std::memory_order_acquire)) {}
+        if (!n) return false;
+        v = n->value;
+        graveyard.push_back(n);
+        return true;
+    }
+
+private:
+    std::atomic<node*> head{nullptr};
+};
+
+template <typename F>
+double run(int threads, F body) {
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() { body(t); });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return static_cast<double>(threads) * ops_per_thread / elapsed / 1e6;
+}
+
+void bench_stack(int threads) {
+    double locked = 0, combined = 0, lock_free = 0;
+    {
+        multithreaded_ds::concurrent_stack<int> stack;
+        locked = run(threads, [&](int) {
+            int v;
+            for (int i = 0; i < ops_per_thread; i += 2) {
+                stack.push(i);
+                stack.pop(v);
+            }
+        });
+    }
+    {
+        multithreaded_ds::flat_combining<multithreaded_ds::fc::stack_ops<int>> stack;
+        combined = run(threads, [&](int) {
+            for (int i = 0; i < ops_per_thread; i += 2) {
+                stack.execute({op::push, i});
+                stack.execute({op::pop});
+            }
+        });
+    }
+    {
+        treiber_stack stack;
+        std::mutex graveyard_mtx;
+        std::vector<treiber_stack::node*> graveyard;
+        lock_free = run(threads, [&](int) {
+            std::vector<treiber_stack::node*> local;
+            int v;
+            for (int i = 0; i < ops_per_thread; i += 2) {
+                stack.push(i);
+                stack.pop(v, local);
+            }
+            std::lock_guard<std::mutex> lock(graveyard_mtx);
+            graveyard.insert(graveyard.end(), local.begin(), local.end());
+        });
+        for (auto n : graveyard) delete n;
+    }
+    std::printf("%-10s %8d %14.2f %14.2f %14.2f\n", "stack", threads, locked, combined, lock_free);
+}
+
+void bench_queue(int threads) {
+    double locked = 0, combined = 0;
+    {
+        multithreaded_ds::concurrent_queue<int> queue;
+        locked = run(threads, [&](int) {
+            int v;
+            for (int i = 0; i < ops_per_thread; i += 2) {
+                queue.push(i);
+                queue.pop(v);
+            }
+        });
+    }
+    {
+        multithreaded_ds::flat_combining<multithreaded_ds::fc::queue_ops<int>> queue;
+        combined = run(threads, [&](int) {
+            for (int i = 0; i < ops_per_thread; i += 2) {
+                queue.execute({op::push, i});
+                queue.execute({op::pop});
+            }
+        });
+    }
+    std::printf("%-10s %8d %14.2f %14.2f %14s\n", "queue", threads, locked, combined, "-");
+}
+
+void bench_skiplist(int threads) {
+    double locked = 0, combined = 0;
+    {
+        multithreaded_ds::Skiplist<int> list;
+        locked = run(threads, [&](int t) {
+            std::mt19937 gen(t);
+            for (int i = 0; i < ops_per_thread; ++i) {
+                int key = static_cast<int>(gen() % 100000);
+                if (i % 4 == 0) list.add(key); else list.search(key);
+            }
+        });
+    }
+    {
+        multithreaded_ds::flat_combining<multithreaded_ds::fc::skiplist_ops<int>> list;
+        combined = run(threads, [&](int t) {
+            std::mt19937 gen(t);
+            for (int i = 0; i < ops_per_thread; ++i) {
+                int key = static_cast<int>(gen() % 100000);
+                list.execute({i % 4 == 0 ? op::add : op::search, key});
+            }
+        });
+    }
+    std::printf("%-10s %8d %14.2f %14.2f %14s\n", "skiplist", threads, locked, combined, "-");
+}
+
+int main() {
+    std::printf("%-10s %8s %14s %14s %14s\n", "structure", "threads", "locked Mops/s", "combined", "lock-free");
+    for (int threads : {1, 2, 4, 8, 16, 32}) {
+        bench_stack(threads);
+        bench_queue(threads);
+        bench_skiplist(threads);
+    }
+    return 0;
+}
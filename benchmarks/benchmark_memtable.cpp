@@ -0,0 +1,54 @@
+#include "../include/multithreaded_ds/concurrent_skiplist.hpp"
+#include "../include/multithreaded_ds/memtable.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+// Fill time of the arena-backed memtable against Skiplist<std::string>::add
+// for the same random 16-byte keys, followed by a lookup pass.
+
+template <typename F>
+double seconds(F body) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    std::printf("%10s %16s %16s %16s %16s\n", "keys", "Skiplist fill s", "memtable fill s", "Skiplist get s", "memtable get s");
+    for (int count : {100000, 1000000}) {
+        std::mt19937_64 gen(42);
+        std::vector<std::string> keys;
+        keys.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            char buf[17];
+            std::snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(gen()));
+            keys.emplace_back(buf, 16);
+        }
+
+        multithreaded_ds::Skiplist<std::string> list;
+        double list_fill = seconds([&]() {
+            for (auto& k : keys) list.add(k);
+        });
+        multithreaded_ds::memtable<> table;
+        double table_fill = seconds([&]() {
+            for (auto& k : keys) table.add(k, "v");
+        });
+
+        std::shuffle(keys.begin(), keys.end(), gen);
+        size_t found = 0;
+        double list_get = seconds([&]() {
+            for (auto& k : keys) found += list.search(k);
+        });
+        double table_get = seconds([&]() {
+            for (auto& k : keys) found += table.contains(k);
+        });
+
+        std::printf("%10d %16.3f %16.3f %16.3f %16.3f\n", count, list_fill, table_fill, list_get, table_get);
+        std::printf("memtable memory usage: %zu bytes (%zu found)\n", table.memory_usage(), found);
+    }
+    return 0;
+}
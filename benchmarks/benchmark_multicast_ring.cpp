@@ -0,0 +1,93 @@
+#include "../include/multithreaded_ds/concurrent_queue.hpp"
+#include "../include/multithreaded_ds/multicast_ring.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// One producer fanning every message out to N consumers (logging,
+// metrics, replication): copying into one concurrent_queue per consumer
+// against a single multicast_ring that all consumers read in place.
+
+struct message {
+    int64_t id = 0;
+    char payload[56] = {};
+};
+
+constexpr int64_t messages = 1000000;
+
+template <typename F>
+double seconds(F body) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+double run_queues(int consumers) {
+    std::vector<std::unique_ptr<multithreaded_ds::concurrent_queue<message>>> queues;
+    for (int i = 0; i < consumers; ++i) {
+        queues.emplace_back(new multithreaded_ds::concurrent_queue<message>());
+    }
+    return seconds([&]() {
+        std::vector<std::thread> threads;
+        for (int i = 0; i < consumers; ++i) {
+            threads.emplace_back([&, i]() {
+                message m;
+                for (int64_t n = 0; n < messages; ++n) {
+                    queues[i]->wait_pop(m);
+                }
+            });
+        }
+        message m;
+        for (int64_t n = 0; n < messages; ++n) {
+            m.id = n;
+            for (auto& q : queues) {
+                q->push(m);
+            }
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+    });
+}
+
+template <typename Wait>
+double run_ring(int consumers, size_t batch) {
+    multithreaded_ds::multicast_ring<message, multithreaded_ds::single_producer, Wait> ring(4096);
+    using consumer = typename decltype(ring)::consumer;
+    std::vector<consumer*> cursors;
+    for (int i = 0; i < consumers; ++i) {
+        cursors.push_back(&ring.add_consumer());
+    }
+    return seconds([&]() {
+        std::vector<std::thread> threads;
+        for (int i = 0; i < consumers; ++i) {
+            threads.emplace_back([&, i]() {
+                int64_t seen = 0;
+                while (seen < messages) {
+                    seen += ring.consume(*cursors[i], [](message&, int64_t, bool) {});
+                }
+            });
+        }
+        for (int64_t n = 0; n < messages; n += static_cast<int64_t>(batch)) {
+            ring.publish_events(batch, [](message& m, int64_t seq) { m.id = seq; });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+    });
+}
+
+int main() {
+    std::printf("%10s %14s %14s %14s %14s\n", "consumers", "queues s", "ring block s", "ring yield s", "ring batch16 s");
+    for (int consumers : {1, 2, 3, 4}) {
+        double queues = run_queues(consumers);
+        double blocking = run_ring<multithreaded_ds::blocking_wait>(consumers, 1);
+        double yielding = run_ring<multithreaded_ds::yielding_wait>(consumers, 1);
+        double batched = run_ring<multithreaded_ds::blocking_wait>(consumers, 16);
+        std::printf("%10d %14.3f %14.3f %14.3f %14.3f\n", consumers, queues, blocking, yielding, batched);
+    }
+    return 0;
+}
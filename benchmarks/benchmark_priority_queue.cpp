@@ -0,0 +1,85 @@
+#include "../include/multithreaded_ds/concurrent_priority_queue.hpp"
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <thread>
+#include <vector>
+
+// Mixed push/pop-min throughput of the skiplist priority queue (exact and
+// sprayed pops) against std::priority_queue behind a mutex. The queues are
+// prefilled so pops rarely find them empty.
+
+constexpr int prefill = 100000;
+constexpr int ops_per_thread = 200000;
+
+class locked_priority_queue {
+public:
+    void push(int v) {
+        std::lock_guard<std::mutex> lock(mtx);
+        queue.push(v);
+    }
+    bool pop(int& v) {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (queue.empty()) return false;
+        v = queue.top();
+        queue.pop();
+        return true;
+    }
+private:
+    std::mutex mtx;
+    std::priority_queue<int, std::vector<int>, std::greater<int>> queue;
+};
+
+template <typename PushFn, typename PopFn>
+double run(int threads, PushFn push, PopFn pop) {
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            std::mt19937 gen(t);
+            std::uniform_int_distribution<int> dis(0, 1 << 30);
+            for (int i = 0; i < ops_per_thread; ++i) {
+                if (i & 1) {
+                    int v;
+                    pop(v);
+                } else {
+                    push(dis(gen));
+                }
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return static_cast<double>(threads) * ops_per_thread / elapsed / 1e6;
+}
+
+int main() {
+    std::printf("%8s %18s %18s %18s\n", "threads", "mutex+std Mops/s", "try_pop_min", "pop_approx_min");
+    for (int threads : {1, 2, 4, 8, 16, 32}) {
+        std::mt19937 gen(42);
+        double locked;
+        {
+            locked_priority_queue queue;
+            for (int i = 0; i < prefill; ++i) queue.push(static_cast<int>(gen() >> 2));
+            locked = run(threads, [&](int v) { queue.push(v); }, [&](int& v) { return queue.pop(v); });
+        }
+        double exact;
+        {
+            multithreaded_ds::concurrent_priority_queue<int> queue(threads);
+            for (int i = 0; i < prefill; ++i) queue.push(static_cast<int>(gen() >> 2));
+            exact = run(threads, [&](int v) { queue.push(v); }, [&](int& v) { return queue.try_pop_min(v); });
+        }
+        double sprayed;
+        {
+            multithreaded_ds::concurrent_priority_queue<int> queue(threads);
+            for (int i = 0; i < prefill; ++i) queue.push(static_cast<int>(gen() >> 2));
+            sprayed = run(threads, [&](int v) { queue.push(v); }, [&](int& v) { return queue.pop_approx_min(v); });
+        }
+        std::printf("%8d %18.2f %18.2f %18.2f\n", threads, locked, exact, sprayed);
+    }
+    return 0;
+}
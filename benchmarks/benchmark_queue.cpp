@@ -0,0 +1,81 @@
+#include "../include/multithreaded_ds/concurrent_queue.hpp"
+#include "../include/multithreaded_ds/sharded_queue.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+// Fan-in throughput of the single-lock queue against the sharded queue.
+// Half of the threads produce and half consume; with one thread the same
+// thread pushes everything and then drains it.
+
+constexpr int messages_per_producer = 200000;
+constexpr size_t consumer_batch = 64;
+
+template <typename PushFn, typename PopFn>
+double run(int threads, PushFn push, PopFn pop) {
+    int producers = threads > 1 ? threads / 2 : 1;
+    int consumers = threads > 1 ? threads - producers : 0;
+    long long total = static_cast<long long>(producers) * messages_per_producer;
+    std::atomic<long long> consumed{0};
+    std::vector<std::thread> workers;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < producers; ++i) {
+        workers.emplace_back([&]() {
+            for (int j = 0; j < messages_per_producer; ++j) {
+                push(j);
+            }
+        });
+    }
+    for (int i = 0; i < consumers; ++i) {
+        workers.emplace_back([&]() {
+            while (consumed.load(std::memory_order_relaxed) < total) {
+                size_t n = pop();
+                if (n == 0) {
+                    std::this_thread::yield();
+                } else {
+                    consumed.fetch_add(static_cast<long long>(n), std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    while (consumed.load() < total) {
+        consumed += static_cast<long long>(pop());
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return total / elapsed / 1e6;
+}
+
+int main() {
+    std::printf("%8s %18s %18s %18s\n", "threads", "single Mmsg/s", "sharded Mmsg/s", "sharded bulk");
+    for (int threads : {1, 2, 4, 8, 16, 32, 64}) {
+        double single;
+        {
+            multithreaded_ds::concurrent_queue<int> queue;
+            single = run(threads,
+                [&](int v) { queue.push(v); },
+                [&]() -> size_t { int v; return queue.pop(v) ? 1 : 0; });
+        }
+        double sharded;
+        {
+            multithreaded_ds::sharded_queue<int> queue;
+            sharded = run(threads,
+                [&](int v) { queue.push(v); },
+                [&]() -> size_t { int v; return queue.try_pop(v) ? 1 : 0; });
+        }
+        double bulk;
+        {
+            multithreaded_ds::sharded_queue<int> queue;
+            bulk = run(threads,
+                [&](int v) { queue.push(v); },
+                [&]() -> size_t { int v[consumer_batch]; return queue.pop_bulk(v, consumer_batch); });
+        }
+        std::printf("%8d %18.2f %18.2f %18.2f\n", threads, single, sharded, bulk);
+    }
+    return 0;
+}
@@ -0,0 +1,43 @@
+#include "../include/multithreaded_ds/concurrent_skiplist.hpp"
+#include "../include/multithreaded_ds/skiplist_io.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+// Restart cost of a Skiplist<long>: re-inserting every key through add()
+// against save_to() followed by load_from(). Key count is the first
+// argument (default 5M).
+
+template <typename F>
+double seconds(F body) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    long count = argc > 1 ? std::atol(argv[1]) : 5000000;
+    const std::string path = "benchmark_skiplist.bin";
+
+    double save = 0;
+    double add = 0;
+    {
+        multithreaded_ds::Skiplist<long> list;
+        add = seconds([&]() {
+            for (long i = 0; i < count; ++i) list.add(i * 2);
+        });
+        save = seconds([&]() { multithreaded_ds::save_to(list, path); });
+    }
+
+    bool ok = false;
+    multithreaded_ds::Skiplist<long> loaded;
+    double load = seconds([&]() { ok = multithreaded_ds::load_from(loaded, path); });
+    std::remove(path.c_str());
+
+    std::printf("keys: %ld\n", count);
+    std::printf("rebuild through add: %8.3f s\n", add);
+    std::printf("save_to:             %8.3f s\n", save);
+    std::printf("load_from:           %8.3f s (%s)\n", load, ok ? "ok" : "failed");
+    return ok ? 0 : 1;
+}
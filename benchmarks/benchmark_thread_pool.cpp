@@ -0,0 +1,84 @@
+#include "../include/multithreaded_ds/threads_pool.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <queue>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+// Request-timeout pattern: arm one timer per request with a 1-30 s timeout
+// and cancel it when the request completes, which is what happens to the
+// vast majority. Compares thread_pool::schedule_after/cancel with a
+// mutex-protected std::priority_queue that cancels lazily via a tombstone
+// set, the usual alternative.
+
+template <typename F>
+double seconds(F body) {
+    auto start = std::chrono::steady_clock::now();
+    body();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+class heap_timers {
+public:
+    uint64_t add(std::chrono::steady_clock::time_point when, std::function<void()> f) {
+        std::lock_guard<std::mutex> lock(mtx);
+        uint64_t id = next_id++;
+        heap.push(entry{when, id, std::move(f)});
+        return id;
+    }
+    void cancel(uint64_t id) {
+        std::lock_guard<std::mutex> lock(mtx);
+        cancelled.insert(id);
+    }
+private:
+    struct entry {
+        std::chrono::steady_clock::time_point when;
+        uint64_t id;
+        std::function<void()> func;
+        bool operator>(const entry& other) const { return when > other.when; }
+    };
+    std::mutex mtx;
+    uint64_t next_id = 0;
+    std::priority_queue<entry, std::vector<entry>, std::greater<entry>> heap;
+    std::unordered_set<uint64_t> cancelled;
+};
+
+int main() {
+    std::printf("%10s %16s %16s %16s %16s\n", "timers", "wheel arm s", "wheel cancel s", "heap arm s", "heap cancel s");
+    for (int count : {100000, 1000000, 4000000}) {
+        std::mt19937 gen(42);
+        std::uniform_int_distribution<int> timeout_ms(1000, 30000);
+        std::vector<int> timeouts(count);
+        for (auto& t : timeouts) t = timeout_ms(gen);
+        std::atomic<int> fired{0};
+
+        multithreaded_ds::thread_pool pool(2);
+        std::vector<multithreaded_ds::thread_pool::timer_handle> handles(count);
+        double wheel_arm = seconds([&]() {
+            for (int i = 0; i < count; ++i) {
+                handles[i] = pool.schedule_after(std::chrono::milliseconds(timeouts[i]), [&fired]() { fired++; });
+            }
+        });
+        double wheel_cancel = seconds([&]() {
+            for (auto& h : handles) pool.cancel(h);
+        });
+
+        heap_timers heap;
+        std::vector<uint64_t> ids(count);
+        double heap_arm = seconds([&]() {
+            auto now = std::chrono::steady_clock::now();
+            for (int i = 0; i < count; ++i) {
+                ids[i] = heap.add(now + std::chrono::milliseconds(timeouts[i]), [&fired]() { fired++; });
+            }
+        });
+        double heap_cancel = seconds([&]() {
+            for (auto id : ids) heap.cancel(id);
+        });
+
+        std::printf("%10d %16.3f %16.3f %16.3f %16.3f\n", count, wheel_arm, wheel_cancel, heap_arm, heap_cancel);
+    }
+    return 0;
+}
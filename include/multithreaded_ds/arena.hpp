@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+namespace multithreaded_ds {
+
+// Bump allocator in the spirit of LevelDB's Arena. Memory is carved out of
+// fixed-size blocks and only released when the arena is destroyed.
+// allocate() is not thread safe; memory_usage() may be read concurrently.
+class arena {
+public:
+    static constexpr size_t default_block_size = 4096;
+
+    explicit arena(size_t block = default_block_size) noexcept
+        : block_size(block), alloc_ptr(nullptr), alloc_remaining(0), m_memory_usage(0) {}
+
+    ~arena() {
+        for (auto b : blocks) {
+            ::operator delete(b);
+        }
+    }
+
+    arena(const arena&) = delete;
+    arena& operator=(const arena&) = delete;
+
+    void* allocate(size_t bytes) {
+        assert(bytes > 0);
+        if (bytes <= alloc_remaining) {
+            char *res = alloc_ptr;
+            alloc_ptr += bytes;
+            alloc_remaining -= bytes;
+            return res;
+        }
+        return allocate_fallback(bytes);
+    }
+
+    void* allocate_aligned(size_t bytes, size_t align = alignof(std::max_align_t)) {
+        assert((align & (align - 1)) == 0);
+        size_t mod = reinterpret_cast<uintptr_t>(alloc_ptr) & (align - 1);
+        size_t slop = mod == 0 ? 0 : align - mod;
+        size_t needed = bytes + slop;
+        if (needed <= alloc_remaining) {
+            char *res = alloc_ptr + slop;
+            alloc_ptr += needed;
+            alloc_remaining -= needed;
+            return res;
+        }
+        // fresh blocks come from operator new and are max_align_t aligned
+        return allocate_fallback(bytes);
+    }
+
+    // bytes reserved from the system, including unused block tails
+    size_t memory_usage() const noexcept {
+        return m_memory_usage.load(std::memory_order_relaxed);
+    }
+
+private:
+    void* allocate_fallback(size_t bytes) {
+        // big objects get their own block so the current one is not wasted
+        if (bytes > block_size / 4) {
+            return allocate_block(bytes);
+        }
+        alloc_ptr = allocate_block(block_size);
+        alloc_remaining = block_size;
+        char *res = alloc_ptr;
+        alloc_ptr += bytes;
+        alloc_remaining -= bytes;
+        return res;
+    }
+
+    char* allocate_block(size_t bytes) {
+        char *res = static_cast<char*>(::operator new(bytes));
+        blocks.push_back(res);
+        m_memory_usage.fetch_add(bytes + sizeof(char*), std::memory_order_relaxed);
+        return res;
+    }
+
+    size_t block_size;
+    char *alloc_ptr;
+    size_t alloc_remaining;
+    std::vector<char*> blocks;
+    std::atomic<size_t> m_memory_usage;
+};
+
+}  // namespace multithreaded_ds
@@ -0,0 +1,463 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <random>
+#include <type_traits>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace multithreaded_ds {
+
+namespace detail {
+
+// Number of keys <= target in a block of B sorted keys whose unused tail
+// is padded with the largest value of T (so it may be over-counted when
+// target is that value; callers clamp to the real count). The primary
+// template is a branchless scalar loop; the specialisations below are
+// picked at compile time for the instruction set the translation unit is
+// built for (-mavx2, -msse4.2, plain x86-64 SSE2).
+enum class key_kind { other, i32, i64, f32, f64 };
+
+template <typename T>
+constexpr key_kind kind_of() {
+    if constexpr (std::is_floating_point_v<T>) {
+        return sizeof(T) == 4 ? key_kind::f32 : sizeof(T) == 8 ? key_kind::f64 : key_kind::other;
+    } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+        return sizeof(T) == 4 ? key_kind::i32 : sizeof(T) == 8 ? key_kind::i64 : key_kind::other;
+    } else {
+        return key_kind::other;
+    }
+}
+
+template <typename T, size_t B, key_kind K = kind_of<T>()>
+struct block_rank {
+    static size_t count(const T *keys, T target) noexcept {
+        size_t res = 0;
+        for (size_t i = 0; i < B; ++i) {
+            res += keys[i] <= target;
+        }
+        return res;
+    }
+};
+
+#if defined(__AVX2__)
+template <typename T, size_t B>
+struct block_rank<T, B, key_kind::i32> {
+    static_assert(B % 8 == 0, "block size must be a multiple of the vector width");
+    static size_t count(const T *keys, T target) noexcept {
+        __m256i t = _mm256_set1_epi32(static_cast<int32_t>(target));
+        size_t greater = 0;
+        for (size_t i = 0; i < B; i += 8) {
+            __m256i k = _mm256_load_si256(reinterpret_cast<const __m256i*>(keys + i));
+            greater += __builtin_popcount(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(k, t))));
+        }
+        return B - greater;
+    }
+};
+
+template <typename T, size_t B>
+struct block_rank<T, B, key_kind::i64> {
+    static_assert(B % 4 == 0, "block size must be a multiple of the vector width");
+    static size_t count(const T *keys, T target) noexcept {
+        __m256i t = _mm256_set1_epi64x(static_cast<int64_t>(target));
+        size_t greater = 0;
+        for (size_t i = 0; i < B; i += 4) {
+            __m256i k = _mm256_load_si256(reinterpret_cast<const __m256i*>(keys + i));
+            greater += __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(k, t))));
+        }
+        return B - greater;
+    }
+};
+
+template <typename T, size_t B>
+struct block_rank<T, B, key_kind::f32> {
+    static_assert(B % 8 == 0, "block size must be a multiple of the vector width");
+    static size_t count(const T *keys, T target) noexcept {
+        __m256 t = _mm256_set1_ps(target);
+        size_t le = 0;
+        for (size_t i = 0; i < B; i += 8) {
+            __m256 k = _mm256_load_ps(keys + i);
+            le += __builtin_popcount(_mm256_movemask_ps(_mm256_cmp_ps(k, t, _CMP_LE_OQ)));
+        }
+        return le;
+    }
+};
+
+template <typename T, size_t B>
+struct block_rank<T, B, key_kind::f64> {
+    static_assert(B % 4 == 0, "block size must be a multiple of the vector width");
+    static size_t count(const T *keys, T target) noexcept {
+        __m256d t = _mm256_set1_pd(target);
+        size_t le = 0;
+        for (size_t i = 0; i < B; i += 4) {
+            __m256d k = _mm256_load_pd(keys + i);
+            le += __builtin_popcount(_mm256_movemask_pd(_mm256_cmp_pd(k, t, _CMP_LE_OQ)));
+        }
+        return le;
+    }
+};
+#elif defined(__SSE2__)
+template <typename T, size_t B>
+struct block_rank<T, B, key_kind::i32> {
+    static_assert(B % 4 == 0, "block size must be a multiple of the vector width");
+    static size_t count(const T *keys, T target) noexcept {
+        __m128i t = _mm_set1_epi32(static_cast<int32_t>(target));
+        size_t greater = 0;
+        for (size_t i = 0; i < B; i += 4) {
+            __m128i k = _mm_load_si128(reinterpret_cast<const __m128i*>(keys + i));
+            greater += __builtin_popcount(_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(k, t))));
+        }
+        return B - greater;
+    }
+};
+
+#if defined(__SSE4_2__)
+template <typename T, size_t B>
+struct block_rank<T, B, key_kind::i64> {
+    static_assert(B % 2 == 0, "block size must be a multiple of the vector width");
+    static size_t count(const T *keys, T target) noexcept {
+        __m128i t = _mm_set1_epi64x(static_cast<int64_t>(target));
+        size_t greater = 0;
+        for (size_t i = 0; i < B; i += 2) {
+            __m128i k = _mm_load_si128(reinterpret_cast<const __m128i*>(keys + i));
+            greater += __builtin_popcount(_mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(k, t))));
+        }
+        return B - greater;
+    }
+};
+#endif
+
+template <typename T, size_t B>
+struct block_rank<T, B, key_kind::f32> {
+    static_assert(B % 4 == 0, "block size must be a multiple of the vector width");
+    static size_t count(const T *keys, T target) noexcept {
+        __m128 t = _mm_set1_ps(target);
+        size_t le = 0;
+        for (size_t i = 0; i < B; i += 4) {
+            le += __builtin_popcount(_mm_movemask_ps(_mm_cmple_ps(_mm_load_ps(keys + i), t)));
+        }
+        return le;
+    }
+};
+
+template <typename T, size_t B>
+struct block_rank<T, B, key_kind::f64> {
+    static_assert(B % 2 == 0, "block size must be a multiple of the vector width");
+    static size_t count(const T *keys, T target) noexcept {
+        __m128d t = _mm_set1_pd(target);
+        size_t le = 0;
+        for (size_t i = 0; i < B; i += 2) {
+            le += __builtin_popcount(_mm_movemask_pd(_mm_cmple_pd(_mm_load_pd(keys + i), t)));
+        }
+        return le;
+    }
+};
+#endif
+
+} // namespace detail
+
+// Fat-node ("B-skiplist") variant of Skiplist for arithmetic keys. Every
+// level is a linked list of nodes holding up to B sorted keys in one or
+// two cache lines, and a key reaches the next level with probability 1/B,
+// so a search touches about log_B(n) levels instead of log_2(n) and looks
+// at each level's keys with a handful of vector compares (detail::
+// block_rank) instead of one pointer hop per key.
+//
+// Node boundaries follow the levels above: a key that also lives on the
+// next level starts its own node here, and its copy up there points down
+// at that node. The keys up to the next such key form a run of one node,
+// or a few when it outgrows B and is split, so a search goes down and
+// then right along one short run per level. Only a run's first node is
+// pointed at from above; the others (continuations) are free to trade keys
+// with their neighbours, so a full node spills into a continuation after
+// it before splitting, an append past its last key gets a node of its own
+// instead of halving it, and a node that erase leaves sparse absorbs the
+// continuation after it. Erasing a key removes it from every level; a
+// node left empty is unlinked by the next search to pass it.
+//
+// Unlike Skiplist each key is stored once: add() returns false for a key
+// that is already present. Operations are serialised by one mutex, like
+// Skiplist's add/search/erase. NaN keys are not supported.
+template <typename T, size_t B = 128 / sizeof(T), int P = 8>
+class BSkiplist {
+    static_assert(std::is_arithmetic_v<T>, "BSkiplist needs arithmetic keys");
+    static_assert(B >= 4 && B % 2 == 0, "BSkiplist nodes hold an even number of keys, at least 4");
+
+private:
+    static constexpr T pad = std::numeric_limits<T>::has_infinity
+        ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+
+    // keys first, cache-line aligned for the vector loads; nodes above
+    // level 0 are allocated with room for B down pointers after the header
+    struct alignas(64) Node {
+        T keys[B];
+        Node *next;
+        uint32_t count;
+        uint16_t level;
+        // keys[0] is pointed down at from the level above, so it must stay
+        bool pinned;
+
+        Node** down() noexcept { return reinterpret_cast<Node**>(this + 1); }
+
+        static Node* create(uint16_t level) {
+            size_t bytes = sizeof(Node) + (level > 0 ? B * sizeof(Node*) : 0);
+            void *mem = ::operator new(bytes, std::align_val_t{alignof(Node)});
+            Node *n = static_cast<Node*>(mem);
+            for (size_t i = 0; i < B; ++i) n->keys[i] = pad;
+            n->next = nullptr;
+            n->count = 0;
+            n->level = level;
+            n->pinned = false;
+            return n;
+        }
+
+        static void destroy(Node *n) noexcept {
+            ::operator delete(n, std::align_val_t{alignof(Node)});
+        }
+
+        // keys <= target
+        size_t rank(T target) const noexcept {
+            size_t res = detail::block_rank<T, B>::count(keys, target);
+            return res < count ? res : count;
+        }
+    };
+
+    Node *m_head[P];
+    int m_levels;
+    size_t m_size;
+    std::mutex mtx;
+    std::mt19937_64 rng{std::random_device{}()};
+
+    int random_height() {
+        int height = 1;
+        while (height < P && rng() % B == 0) ++height;
+        return height;
+    }
+
+    // Last node of the level, starting from n, whose first key is <= target.
+    // Nodes emptied by erase are unlinked on the way; nothing points down
+    // at them any more (see erase).
+    static Node* advance(Node *n, T target) noexcept {
+        while (Node *next = n->next) {
+            if (next->count == 0) {
+                n->next = next->next;
+                Node::destroy(next);
+                continue;
+            }
+            if (next->keys[0] > target) break;
+            n = next;
+        }
+        return n;
+    }
+
+    // Fills preds[level] with the node target belongs in at every level.
+    // Returns the highest level target is present at, -1 if absent.
+    int find_preds(T target, Node **preds) noexcept {
+        int found = -1;
+        Node *n = m_head[m_levels - 1];
+        for (int level = m_levels - 1; level >= 0; --level) {
+            n = advance(n, target);
+            preds[level] = n;
+            size_t idx = n->rank(target);
+            if (found < 0 && idx > 0 && n->keys[idx - 1] == target) {
+                found = level;
+            }
+            if (level > 0) {
+                // only a head node has no key <= target
+                n = idx == 0 ? m_head[level - 1] : n->down()[idx - 1];
+            }
+        }
+        return found;
+    }
+
+    // fresh node of n's level linked right after n
+    static Node* link_after(Node *n) {
+        Node *res = Node::create(n->level);
+        res->next = n->next;
+        n->next = res;
+        return res;
+    }
+
+    static void place(Node *n, size_t pos, T key, Node *down) noexcept {
+        for (size_t i = n->count; i > pos; --i) {
+            n->keys[i] = n->keys[i - 1];
+            if (n->level > 0) n->down()[i] = n->down()[i - 1];
+        }
+        n->keys[pos] = key;
+        if (n->level > 0) n->down()[pos] = down;
+        ++n->count;
+    }
+
+    static void move_key(Node *to, size_t to_pos, Node *from, size_t from_pos) noexcept {
+        to->keys[to_pos] = from->keys[from_pos];
+        if (to->level > 0) to->down()[to_pos] = from->down()[from_pos];
+    }
+
+    // Inserts key (with its down pointer above level 0) into n. A full n
+    // pushes its last key (or key itself, when it goes last) to the front
+    // of a continuation after it with room, hands an append past its last
+    // key a node of its own, and only otherwise moves its upper half to a
+    // new node. The first key of n never moves, so down pointers to n stay
+    // exact.
+    Node* insert_into(Node *n, T key, Node *down) {
+        size_t pos = n->rank(key);
+        if (n->count == B) {
+            Node *next = n->next;
+            if (next && !next->pinned && next->count < B) {
+                if (pos == B) {
+                    place(next, 0, key, down);
+                    return next;
+                }
+                place(next, 0, n->keys[B - 1], n->level > 0 ? n->down()[B - 1] : nullptr);
+                n->keys[B - 1] = pad;
+                --n->count;
+            } else if (pos == B) {
+                Node *right = link_after(n);
+                place(right, 0, key, down);
+                return right;
+            }
+        }
+        if (n->count == B) {
+            Node *right = link_after(n);
+            constexpr size_t half = B / 2;
+            for (size_t i = 0; i < half; ++i) {
+                move_key(right, i, n, half + i);
+                n->keys[half + i] = pad;
+            }
+            right->count = half;
+            n->count = half;
+            if (pos > half) {
+                n = right;
+                pos -= half;
+            }
+        }
+        place(n, pos, key, down);
+        return n;
+    }
+
+    // Inserts key at a level below its top one: key starts a new node (the
+    // one its copy on the level above points down to) that takes over
+    // every key of n after it.
+    Node* split_at(Node *n, T key, Node *down) {
+        size_t pos = n->rank(key);
+        Node *res = link_after(n);
+        place(res, 0, key, down);
+        res->pinned = true;
+        Node *tail = res;
+        for (size_t i = pos; i < n->count; ++i) {
+            if (tail->count == B) {
+                tail = link_after(tail);
+            }
+            move_key(tail, tail->count++, n, i);
+            n->keys[i] = pad;
+        }
+        n->count = static_cast<uint32_t>(pos);
+        return res;
+    }
+
+    // Removes key from n; when n and the continuation after it then fit
+    // in three quarters of a node, n takes over its keys and it is freed.
+    // Nothing points down at a continuation, and n is the only node
+    // linked to it.
+    static void remove_from(Node *n, T key) noexcept {
+        size_t pos = n->rank(key) - 1;
+        for (size_t i = pos; i + 1 < n->count; ++i) {
+            move_key(n, i, n, i + 1);
+        }
+        --n->count;
+        n->keys[n->count] = pad;
+        Node *next = n->next;
+        if (next && !next->pinned && n->count + next->count <= B * 3 / 4) {
+            for (size_t i = 0; i < next->count; ++i) {
+                move_key(n, n->count++, next, i);
+            }
+            n->next = next->next;
+            Node::destroy(next);
+        }
+    }
+
+public:
+    BSkiplist() : m_levels(1), m_size(0) {
+        m_head[0] = Node::create(0);
+    }
+
+    ~BSkiplist() {
+        for (int level = 0; level < m_levels; ++level) {
+            Node *n = m_head[level];
+            while (n) {
+                Node *next = n->next;
+                Node::destroy(n);
+                n = next;
+            }
+        }
+    }
+
+    BSkiplist(const BSkiplist&) = delete;
+    BSkiplist& operator=(const BSkiplist&) = delete;
+
+    bool search(T target) {
+        std::lock_guard<std::mutex> lock(mtx);
+        Node *n = m_head[m_levels - 1];
+        for (int level = m_levels - 1; ; --level) {
+            n = advance(n, target);
+            size_t idx = n->rank(target);
+            if (idx > 0 && n->keys[idx - 1] == target) {
+                return true;
+            }
+            if (level == 0) {
+                return false;
+            }
+            n = idx == 0 ? m_head[level - 1] : n->down()[idx - 1];
+        }
+    }
+
+    bool add(T num) {
+        std::lock_guard<std::mutex> lock(mtx);
+        Node *preds[P];
+        if (find_preds(num, preds) >= 0) {
+            return false;
+        }
+        int height = random_height();
+        while (m_levels < height) {
+            m_head[m_levels] = Node::create(static_cast<uint16_t>(m_levels));
+            preds[m_levels] = m_head[m_levels];
+            ++m_levels;
+        }
+        Node *below = nullptr;
+        for (int level = 0; level + 1 < height; ++level) {
+            below = split_at(preds[level], num, below);
+        }
+        insert_into(preds[height - 1], num, below);
+        ++m_size;
+        return true;
+    }
+
+    bool erase(T num) {
+        std::lock_guard<std::mutex> lock(mtx);
+        Node *preds[P];
+        int found = find_preds(num, preds);
+        if (found < 0) {
+            return false;
+        }
+        for (int level = 0; level <= found; ++level) {
+            // below its top level num heads a node its copy points down at
+            if (level < found) preds[level]->pinned = false;
+            remove_from(preds[level], num);
+        }
+        --m_size;
+        return true;
+    }
+
+    size_t size() {
+        std::lock_guard<std::mutex> lock(mtx);
+        return m_size;
+    }
+};
+
+} // namespace multithreaded_ds
@@ -0,0 +1,285 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace multithreaded_ds {
+
+// Skiplist-based priority queue in the Lotan-Shavit style.
+//
+// Inserts are serialised by `mtx` like Skiplist::add, but publish their
+// links with release stores so that pops can run without the lock: a pop
+// walks the bottom level from the head and claims the first node whose
+// `deleted` flag it manages to set. Claimed nodes are unlinked later in
+// batches by whoever gets the lock, and freed only after every pop that
+// could still be looking at them has finished (two-epoch reclamation).
+//
+// pop_approx_min() follows the SprayList idea: instead of all threads
+// fighting over the first node, each one lands on a random node among the
+// first O(p log p) and claims from there, where p is the spray width.
+template <typename T, typename Compare = std::less<T>, int P = 20>
+class concurrent_priority_queue {
+private:
+    // Nodes are allocated with exactly `height` links (LevelDB style), which
+    // keeps most nodes within a cache line instead of carrying P pointers.
+    struct Node {
+        T value;
+        std::atomic<bool> deleted;
+        int height;
+        std::atomic<Node*> next[1];
+
+        template <typename... Args>
+        static Node* create(int height, Args&&... args) {
+            void *mem = ::operator new(sizeof(Node) + (height - 1) * sizeof(std::atomic<Node*>));
+            Node *n = new(mem) Node(height, std::forward<Args>(args)...);
+            for (int level = 1; level < height; ++level) {
+                new(&n->next[level]) std::atomic<Node*>(nullptr);
+            }
+            return n;
+        }
+
+        static void destroy(Node *n) {
+            n->~Node();
+            ::operator delete(n);
+        }
+
+    private:
+        template <typename... Args>
+        Node(int h, Args&&... args) : value(std::forward<Args>(args)...), deleted(false), height(h) {
+            next[0].store(nullptr, std::memory_order_relaxed);
+        }
+    };
+
+    struct Head {
+        std::atomic<Node*> next[P];
+        Head() {
+            for (auto &n : next) n.store(nullptr, std::memory_order_relaxed);
+        }
+    };
+
+    // Registers a lock-free reader in the current epoch for its lifetime.
+    class reader_guard {
+    public:
+        explicit reader_guard(concurrent_priority_queue &q) noexcept : owner(q) {
+            while (true) {
+                epoch = owner.m_epoch.load(std::memory_order_seq_cst);
+                owner.m_readers[epoch & 1].fetch_add(1, std::memory_order_seq_cst);
+                if (owner.m_epoch.load(std::memory_order_seq_cst) == epoch) break;
+                owner.m_readers[epoch & 1].fetch_sub(1, std::memory_order_seq_cst);
+            }
+        }
+        ~reader_guard() noexcept {
+            owner.m_readers[epoch & 1].fetch_sub(1, std::memory_order_seq_cst);
+        }
+    private:
+        concurrent_priority_queue &owner;
+        uint64_t epoch;
+    };
+
+    // claimed nodes walked past before a pop tries to clean up
+    static constexpr size_t cleanup_threshold = 64;
+
+    Head m_head;
+    Compare comp;
+    std::mutex mtx;
+    std::mt19937_64 rng{std::random_device{}()};
+    // live (unclaimed) elements
+    std::atomic<size_t> m_size{0};
+    // top level and maximum jump length of a spray, derived from the width
+    int m_spray_start;
+    uint64_t m_spray_jump;
+    // how far past the front sprayed pops may land, bounds cleanup scans
+    size_t m_spray_reach;
+
+    std::atomic<uint64_t> m_epoch{0};
+    std::atomic<int64_t> m_readers[2];
+    // unlinked during the previous / current epoch, guarded by mtx
+    std::vector<Node*> retired_prev;
+    std::vector<Node*> retired_cur;
+
+    bool random_level_check() {
+        return rng() % 2 == 0;
+    }
+
+    static uint64_t thread_random() noexcept {
+        static std::atomic<uint64_t> seed{0x9e3779b97f4a7c15ULL};
+        thread_local uint64_t state = seed.fetch_add(0x9e3779b97f4a7c15ULL, std::memory_order_relaxed) | 1;
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+    // Claims the first unclaimed node at or after `from` on the bottom level.
+    bool claim_from(Node *from, T& value) {
+        size_t skipped = 0;
+        Node *cur = from;
+        while (cur) {
+            if (!cur->deleted.load(std::memory_order_relaxed) &&
+                !cur->deleted.exchange(true, std::memory_order_acq_rel)) {
+                value = cur->value;
+                m_size.fetch_sub(1, std::memory_order_relaxed);
+                break;
+            }
+            ++skipped;
+            cur = cur->next[0].load(std::memory_order_acquire);
+        }
+        if (skipped >= cleanup_threshold) {
+            std::unique_lock<std::mutex> lock(mtx, std::try_to_lock);
+            if (lock.owns_lock()) {
+                cleanup();
+            }
+        }
+        return cur != nullptr;
+    }
+
+    // Unlinks claimed nodes near the front and frees what is safe to free.
+    // Caller holds mtx.
+    void cleanup() {
+        std::atomic<Node*>* preds[P];
+        for (int level = 0; level < P; ++level) {
+            preds[level] = m_head.next;
+        }
+        // claimed nodes cluster within the spray reach of the front; stop
+        // after a run of live ones longer than that
+        size_t live_run = 0;
+        Node *cur = m_head.next[0].load(std::memory_order_relaxed);
+        while (cur && live_run < cleanup_threshold + m_spray_reach) {
+            Node *next = cur->next[0].load(std::memory_order_relaxed);
+            if (cur->deleted.load(std::memory_order_acquire)) {
+                for (int level = 0; level < cur->height; ++level) {
+                    preds[level][level].store(cur->next[level].load(std::memory_order_relaxed),
+                                              std::memory_order_release);
+                }
+                retired_cur.push_back(cur);
+                live_run = 0;
+            } else {
+                for (int level = 0; level < cur->height; ++level) {
+                    preds[level] = cur->next;
+                }
+                ++live_run;
+            }
+            cur = next;
+        }
+
+        uint64_t epoch = m_epoch.load(std::memory_order_seq_cst);
+        if (m_readers[(epoch + 1) & 1].load(std::memory_order_seq_cst) == 0) {
+            for (auto n : retired_prev) {
+                Node::destroy(n);
+            }
+            retired_prev.swap(retired_cur);
+            retired_cur.clear();
+            m_epoch.store(epoch + 1, std::memory_order_seq_cst);
+        }
+    }
+
+public:
+    explicit concurrent_priority_queue(size_t spray_width = std::thread::hardware_concurrency(),
+                                       Compare c = Compare())
+        : comp(std::move(c)) {
+        m_readers[0].store(0);
+        m_readers[1].store(0);
+        int log_p = 0;
+        while ((size_t(1) << (log_p + 1)) <= spray_width) ++log_p;
+        m_spray_start = std::min(P - 1, log_p + 1);
+        m_spray_jump = static_cast<uint64_t>(log_p) + 1;
+        m_spray_reach = m_spray_jump << (m_spray_start + 1);
+    }
+
+    ~concurrent_priority_queue() {
+        Node *cur = m_head.next[0].load(std::memory_order_relaxed);
+        while (cur) {
+            Node *next = cur->next[0].load(std::memory_order_relaxed);
+            Node::destroy(cur);
+            cur = next;
+        }
+        for (auto n : retired_prev) Node::destroy(n);
+        for (auto n : retired_cur) Node::destroy(n);
+    }
+
+    concurrent_priority_queue(const concurrent_priority_queue&) = delete;
+    concurrent_priority_queue& operator=(const concurrent_priority_queue&) = delete;
+
+    template <typename... Args>
+    void emplace(Args&&... args) {
+        std::lock_guard<std::mutex> lock(mtx);
+        int height = 1;
+        while (height < P && random_level_check()) ++height;
+        Node *newNode = Node::create(height, std::forward<Args>(args)...);
+
+        std::atomic<Node*>* update[P];
+        std::atomic<Node*>* cur = m_head.next;
+        for (int level = P - 1; level >= 0; --level) {
+            Node *next = cur[level].load(std::memory_order_relaxed);
+            while (next && comp(next->value, newNode->value)) {
+                cur = next->next;
+                next = cur[level].load(std::memory_order_relaxed);
+            }
+            update[level] = cur;
+        }
+
+        // bottom up, so a node is reachable on level 0 before any upper level
+        for (int level = 0; level < height; ++level) {
+            newNode->next[level].store(update[level][level].load(std::memory_order_relaxed),
+                                       std::memory_order_relaxed);
+            update[level][level].store(newNode, std::memory_order_release);
+        }
+        m_size.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void push(const T& value) {
+        emplace(value);
+    }
+
+    void push(T&& value) {
+        emplace(std::move(value));
+    }
+
+    // Removes the smallest element. Returns false if the queue was empty.
+    bool try_pop_min(T& value) {
+        reader_guard guard(*this);
+        return claim_from(m_head.next[0].load(std::memory_order_acquire), value);
+    }
+
+    // Removes an element among roughly the first spray_width * log(spray_width)
+    // smallest ones, spreading concurrent pops away from the head.
+    bool pop_approx_min(T& value) {
+        {
+            reader_guard guard(*this);
+            std::atomic<Node*>* cur = m_head.next;
+            Node *landed = nullptr;
+            for (int level = m_spray_start; level >= 0; --level) {
+                uint64_t jumps = thread_random() % (m_spray_jump + 1);
+                for (uint64_t j = 0; j < jumps; ++j) {
+                    Node *next = cur[level].load(std::memory_order_acquire);
+                    if (!next) break;
+                    landed = next;
+                    cur = next->next;
+                }
+            }
+            Node *from = landed ? landed : m_head.next[0].load(std::memory_order_acquire);
+            if (claim_from(from, value)) {
+                return true;
+            }
+        }
+        // sprayed past the last live element
+        return try_pop_min(value);
+    }
+
+    size_t size() const noexcept {
+        return m_size.load(std::memory_order_relaxed);
+    }
+
+    bool isEmpty() const noexcept {
+        return size() == 0;
+    }
+};
+
+}  // namespace multithreaded_ds
@@ -1,6 +1,14 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <mutex>
+#include <optional>
+#include <utility>
+
+#include "futex.hpp"
+#include "stats.hpp"
 
 namespace multithreaded_ds {
 
@@ -10,91 +18,238 @@ private:
     struct Node {
         Node *next;
         T data;
-        Node(const T &init) : data(init), next(nullptr) {}
+        template <typename... Args>
+        Node(Args&&... args) : next(nullptr), data(std::forward<Args>(args)...) {}
     };
 
     // front of the queue
     Node *front;
     // back of the queue
     Node *back;
-    // size of the queue
-    size_t queue_size;
-    // lock of the stack
+    // size of the queue, also read without the lock by spinning consumers
+    std::atomic<size_t> queue_size;
+    // lock of the queue
     std::mutex mtx;
+    // set once by close(), read without the lock by waiters
+    std::atomic<bool> closed;
+    // futex word bumped whenever a sleeping consumer must re-check the queue
+    std::atomic<uint32_t> m_signal;
+    // number of consumers parked (or about to park) on m_signal
+    std::atomic<uint32_t> m_sleepers;
+    // adaptive spin budget for wait_pop, grows when spinning pays off
+    std::atomic<uint32_t> m_spin_limit;
+
+    static constexpr uint32_t min_spin = 16;
+    static constexpr uint32_t max_spin = 4096;
+    // instrumentation, empty unless MULTITHREADED_DS_ENABLE_STATS is set
+    stats::counters<stats::queue_counter> m_stats;
+
+    using lock_guard = stats::timed_lock_guard<std::mutex, stats::queue_counter>;
+
+    // links a node in, returns false (and frees it) if the queue is closed
+    bool link(Node *new_node) noexcept {
+        {
+            lock_guard lock(mtx, m_stats);
+            if (closed.load(std::memory_order_relaxed)) {
+                delete new_node;
+                return false;
+            }
+            if (back == nullptr) {
+                front = back = new_node;
+            } else {
+                back->next = new_node;
+                back = new_node;
+            }
+            queue_size++;
+            m_stats.add(stats::queue_counter::pushes);
+            m_stats.update_max(stats::queue_counter::max_depth, queue_size);
+        }
+        // pairs with the seq_cst increment in wait_pop_until(): either the consumer
+        // sees the new node or we see it sleeping and wake it
+        if (m_sleepers.load(std::memory_order_seq_cst) != 0) {
+            m_signal.fetch_add(1, std::memory_order_release);
+            futex_wake(m_signal, 1);
+        }
+        return true;
+    }
+
+    // Spins for a while on the lock-free size hint before falling back to
+    // the futex. Returns once the queue looks non-empty or is closed.
+    bool spin_for_item() noexcept {
+        uint32_t limit = m_spin_limit.load(std::memory_order_relaxed);
+        for (uint32_t i = 0; i < limit; ++i) {
+            if (queue_size.load(std::memory_order_relaxed) != 0 || closed.load(std::memory_order_relaxed)) {
+                if (limit < max_spin) m_spin_limit.store(limit * 2, std::memory_order_relaxed);
+                return true;
+            }
+            cpu_relax();
+        }
+        if (limit > min_spin) m_spin_limit.store(limit / 2, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Shared body of wait_pop and wait_pop_for; a null deadline waits forever.
+    bool wait_pop_until(T& value, const stats::clock::time_point *deadline) noexcept {
+        while (true) {
+            if (pop(value)) return true;
+            // no push can succeed after close, so one more pop decides it
+            if (closed.load(std::memory_order_acquire)) return pop(value);
+            if (spin_for_item()) continue;
+
+            uint32_t seq = m_signal.load(std::memory_order_acquire);
+            m_sleepers.fetch_add(1, std::memory_order_seq_cst);
+            if (pop(value)) {
+                m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+            if (closed.load(std::memory_order_acquire)) {
+                m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+                continue;
+            }
+            if (deadline) {
+                auto left = *deadline - stats::clock::now();
+                if (left <= stats::clock::duration::zero()) {
+                    m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+                    return pop(value);
+                }
+                auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(left);
+                futex_wait(m_signal, seq, &ns);
+            } else {
+                futex_wait(m_signal, seq);
+            }
+            m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
 
 public:
-    concurrent_queue() noexcept : front(nullptr), back(nullptr), queue_size(0) {}
+    concurrent_queue() noexcept
+        : front(nullptr), back(nullptr), queue_size(0), closed(false),
+          m_signal(0), m_sleepers(0), m_spin_limit(256) {}
     
     ~concurrent_queue() noexcept {
         clear();
     }
 
-    void push(const T& value) noexcept {
-        std::lock_guard<std::mutex> lock(mtx);
-        Node* new_node = new Node(value);
-        if (front == nullptr) {
-            front = back = new_node;
-        } else {
-            new_node->next = front;
-            front = new_node;
-        }
-        queue_size++;
+    bool push(const T& value) noexcept {
+        return link(new Node(value));
+    }
+
+    bool push(T&& value) noexcept {
+        return link(new Node(std::move(value)));
     }
 
     template <typename... Args>
-    void emplace(Args&&... args) noexcept {
-        std::lock_guard<std::mutex> lock(mtx);
-        Node *new_node = new Node(std::forward<Args>(args)...);
-        if (front == nullptr) {
-            front = back = new_node;
-        } else {
-            new_node->next = front;
-            front = new_node;
-        }
-        queue_size++;
+    bool emplace(Args&&... args) noexcept {
+        return link(new Node(std::forward<Args>(args)...));
     }
 
     bool pop(T& value) noexcept {
-        std::lock_guard<std::mutex> lock(mtx);
+        lock_guard lock(mtx, m_stats);
         if (front == nullptr) {
             return false;
         }
         Node* old_front = front;
-        value = old_front->data;
+        value = std::move(old_front->data);
         front = old_front->next;
+        if (front == nullptr) {
+            back = nullptr;
+        }
         delete old_front;
         queue_size--;
+        m_stats.add(stats::queue_counter::pops);
         return true;
     }
 
+    std::optional<T> pop() noexcept {
+        std::optional<T> res;
+        Node* old_front;
+        {
+            lock_guard lock(mtx, m_stats);
+            if (front == nullptr) {
+                return res;
+            }
+            old_front = front;
+            front = old_front->next;
+            if (front == nullptr) {
+                back = nullptr;
+            }
+            queue_size--;
+            m_stats.add(stats::queue_counter::pops);
+        }
+        res.emplace(std::move(old_front->data));
+        delete old_front;
+        return res;
+    }
+
     bool isEmpty() noexcept {
-        std::lock_guard<std::mutex> lock(mtx);
+        lock_guard lock(mtx, m_stats);
         return front == nullptr;
     }
 
     size_t size() noexcept {
-        std::lock_guard<std::mutex> lock(mtx);
+        lock_guard lock(mtx, m_stats);
         return queue_size;
     }
 
     void clear() noexcept {
-        std::lock_guard<std::mutex> lock(mtx);
+        lock_guard lock(mtx, m_stats);
         while (front != nullptr) {
             Node* old_front = front;
             front = old_front->next;
             delete old_front;
         }
+        back = nullptr;
         queue_size = 0;
     }
 
     bool peek(T& value) noexcept {
-        std::lock_guard<std::mutex> lock(mtx);
+        lock_guard lock(mtx, m_stats);
         if (front == nullptr) {
             return false;
         }
         value = front->data;
         return true;
     }
+
+    // Blocks until an element is available. Returns false only once the
+    // queue has been closed and fully drained.
+    bool wait_pop(T& value) noexcept {
+        return wait_pop_until(value, nullptr);
+    }
+
+    // Like wait_pop, but gives up and returns false after `timeout`.
+    template <typename Rep, typename Period>
+    bool wait_pop_for(T& value, const std::chrono::duration<Rep, Period>& timeout) noexcept {
+        auto deadline = stats::clock::now() + std::chrono::duration_cast<stats::clock::duration>(timeout);
+        return wait_pop_until(value, &deadline);
+    }
+
+    // Rejects further pushes and wakes every waiter. Elements already in the
+    // queue can still be popped; waiters return false once it is empty.
+    void close() noexcept {
+        {
+            lock_guard lock(mtx, m_stats);
+            closed.store(true, std::memory_order_release);
+        }
+        m_signal.fetch_add(1, std::memory_order_release);
+        futex_wake_all(m_signal);
+    }
+
+    bool isClosed() noexcept {
+        return closed.load(std::memory_order_acquire);
+    }
+
+    stats::queue_snapshot stats() const noexcept {
+        using c = stats::queue_counter;
+        stats::queue_snapshot res;
+        res.pushes = m_stats.sum(c::pushes);
+        res.pops = m_stats.sum(c::pops);
+        res.lock_acquisitions = m_stats.sum(c::lock_acquisitions);
+        res.lock_wait_ns = m_stats.sum(c::lock_wait_ns);
+        res.lock_hold_ns = m_stats.sum(c::lock_hold_ns);
+        res.max_depth = m_stats.max(c::max_depth);
+        return res;
+    }
 };
 
 }  // namespace multithreaded_ds
\ No newline at end of file
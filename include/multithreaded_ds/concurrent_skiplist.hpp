@@ -5,17 +5,65 @@
 #include <optional>
 #include <random>
 #include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <set>
+#include <utility>
+#include <algorithm>
+
+#include "arena.hpp"
 
 namespace multithreaded_ds {
 
 template <typename T, int P = 20>
 class Skiplist {
 private:
+    static constexpr uint64_t live = UINT64_MAX;
+
+    // Links are atomic so snapshot iterators can walk the list without the
+    // lock; writers still serialise on mtx. A node is a single allocation
+    // holding exactly `height` links.
     struct Node {
-        std::vector<Node*> next;
         std::optional<T> value;
-        Node(std::optional<T> val = std::nullopt)
-            : value(val), next(P, nullptr) {}
+        // list version that added / erased the node
+        uint64_t version_added;
+        std::atomic<uint64_t> version_erased;
+        int height;
+        // carved out of the bulk-load arena, released together with it
+        bool in_arena;
+        std::atomic<Node*> next[1];
+
+        static Node* create(int height, std::optional<T> val = std::nullopt, uint64_t version = 0,
+                            arena *from = nullptr) {
+            size_t bytes = sizeof(Node) + (height - 1) * sizeof(std::atomic<Node*>);
+            void *mem = from ? from->allocate_aligned(bytes, alignof(Node)) : ::operator new(bytes);
+            Node *n = new(mem) Node(height, std::move(val), version, from != nullptr);
+            for (int level = 1; level < height; ++level) {
+                new(&n->next[level]) std::atomic<Node*>(nullptr);
+            }
+            return n;
+        }
+
+        static void destroy(Node *n) {
+            bool owned = !n->in_arena;
+            n->~Node();
+            if (owned) {
+                ::operator delete(n);
+            }
+        }
+
+        bool is_live() const noexcept {
+            return version_erased.load(std::memory_order_relaxed) == live;
+        }
+
+        bool visible_at(uint64_t version) const noexcept {
+            return version_added <= version && version_erased.load(std::memory_order_acquire) > version;
+        }
+
+    private:
+        Node(int h, std::optional<T> val, uint64_t version, bool arena_owned)
+            : value(std::move(val)), version_added(version), version_erased(live),
+              height(h), in_arena(arena_owned), next{nullptr} {}
     };
 
     Node* m_head;
@@ -25,87 +73,367 @@ private:
         return rng() % 2 == 0;
     }
 
+    int random_height() {
+        int height = 1;
+        while (height < P && random_level_check()) ++height;
+        return height;
+    }
+
     std::mutex mtx;
 
+    // bumped by every add and erase, guarded by mtx
+    uint64_t m_version = 0;
+    // versions of the open snapshots, guarded by mtx
+    std::multiset<uint64_t> m_snapshots;
+    // erased while a snapshot could still see them; still linked
+    std::vector<Node*> m_zombies;
+    // unlinked, freed once every snapshot older than the unlink is gone
+    std::vector<std::pair<uint64_t, Node*>> m_retired;
+    // backing stores for nodes built by append_sorted, one per load
+    std::vector<std::unique_ptr<arena>> m_bulk;
+    static constexpr size_t bulk_block_size = 1 << 20;
+
+    static Node* next_of(const Node *n, int level) noexcept {
+        return n->next[level].load(std::memory_order_acquire);
+    }
+
+    // fills update[] with the last node before `key` on every level
+    void find_preds(const T &key, Node **update) {
+        auto cur = m_head;
+        for (int level = P - 1; level >= 0; --level) {
+            Node *next;
+            while ((next = next_of(cur, level)) && next->value.value() < key) {
+                cur = next;
+            }
+            update[level] = cur;
+        }
+    }
+
+    // first live node holding `key` after update[0], skipping erased entries
+    static Node* find_live(Node **update, const T &key) {
+        Node *cur = next_of(update[0], 0);
+        while (cur && cur->value.value() == key) {
+            if (cur->is_live()) return cur;
+            cur = next_of(cur, 0);
+        }
+        return nullptr;
+    }
+
+    void link(Node **update, T num) {
+        int height = random_height();
+        auto newNode = Node::create(height, num, ++m_version);
+        for (int level = 0; level < height; ++level) {
+            newNode->next[level].store(next_of(update[level], level), std::memory_order_relaxed);
+            update[level]->next[level].store(newNode, std::memory_order_release);
+        }
+    }
+
+    // update[] must hold target's direct predecessors
+    static void unlink(Node **update, Node *target) {
+        for (int level = P - 1; level >= 0; --level) {
+            if (next_of(update[level], level) == target) {
+                update[level]->next[level].store(next_of(target, level), std::memory_order_release);
+            }
+        }
+    }
+
+    // Erases the first live `key` after update[]. While snapshots are open
+    // the node is only stamped with the erase version and stays linked.
+    bool remove(Node **update, const T &key) {
+        Node *target = find_live(update, key);
+        if (!target) {
+            return false;
+        }
+        if (m_snapshots.empty()) {
+            // no snapshots means no zombies, so target follows update[] directly
+            unlink(update, target);
+            Node::destroy(target);
+        } else {
+            target->version_erased.store(++m_version, std::memory_order_release);
+            m_zombies.push_back(target);
+        }
+        return true;
+    }
+
+    // Unlinks zombies no open snapshot can see and frees retired nodes no
+    // open snapshot can reach. Caller holds mtx.
+    void collect_garbage() {
+        uint64_t oldest = m_snapshots.empty() ? live : *m_snapshots.begin();
+        std::vector<Node*> still_visible;
+        for (auto target : m_zombies) {
+            if (target->version_erased.load(std::memory_order_relaxed) > oldest) {
+                still_visible.push_back(target);
+                continue;
+            }
+            Node *update[P];
+            find_preds(target->value.value(), update);
+            // step over equal keys until the predecessor of target itself
+            for (int level = P - 1; level >= 0; --level) {
+                Node *next;
+                while ((next = next_of(update[level], level)) && next != target &&
+                       !(target->value.value() < next->value.value())) {
+                    update[level] = next;
+                }
+            }
+            unlink(update, target);
+            m_retired.emplace_back(m_version, target);
+        }
+        m_zombies.swap(still_visible);
+
+        size_t kept = 0;
+        for (auto &r : m_retired) {
+            if (r.first < oldest) {
+                Node::destroy(r.second);
+            } else {
+                m_retired[kept++] = r;
+            }
+        }
+        m_retired.resize(kept);
+    }
+
+    void release_snapshot(uint64_t version) {
+        std::lock_guard<std::mutex> lock(mtx);
+        m_snapshots.erase(m_snapshots.find(version));
+        collect_garbage();
+    }
+
 public:
     Skiplist() {
-        m_head = new Node();
+        m_head = Node::create(P);
     }
 
     ~Skiplist() {
         auto cur = m_head;
         while (cur) {
-            auto next = cur->next[0];
-            delete cur;
+            auto next = next_of(cur, 0);
+            Node::destroy(cur);
             cur = next;
         }
+        for (auto &r : m_retired) {
+            Node::destroy(r.second);
+        }
     }
 
     bool search(T target) {
         std::lock_guard<std::mutex> lock(mtx);
-        auto cur = m_head;
-        for (int level = P - 1; level >= 0; --level) {
-            while (cur->next[level] && cur->next[level]->value.value() < target) {
-                cur = cur->next[level];
-            }
-        }
-        cur = cur->next[0];
-        return cur && cur->value.has_value() && cur->value.value() == target;
+        Node *update[P];
+        find_preds(target, update);
+        return find_live(update, target) != nullptr;
     }
 
     void add(T num) {
         std::lock_guard<std::mutex> lock(mtx);
-        std::vector<Node*> update(P, nullptr);
-        auto cur = m_head;
+        Node *update[P];
+        find_preds(num, update);
+        link(update, num);
+    }
 
-        for (int level = P - 1; level >= 0; --level) {
-            while (cur->next[level] && cur->next[level]->value.value() < num) {
-                cur = cur->next[level];
+    bool erase(T num) {
+        std::lock_guard<std::mutex> lock(mtx);
+        Node *update[P];
+        find_preds(num, update);
+        return remove(update, num);
+    }
+
+    // Point-in-time, read-only view of the list. Iterating it takes no lock,
+    // so writers keep going; entries they add or erase afterwards are not
+    // seen. Erased entries stay in memory until every snapshot that can see
+    // them is destroyed. Iterators must not outlive their snapshot.
+    class snapshot_handle {
+    public:
+        class iterator {
+        public:
+            explicit iterator(const snapshot_handle &s) noexcept : snap(s), node(nullptr) {}
+
+            bool valid() const noexcept { return node != nullptr; }
+            const T& value() const noexcept { return node->value.value(); }
+
+            void next() noexcept {
+                node = skip_invisible(next_of(node, 0));
+            }
+
+            void seek_to_first() noexcept {
+                node = skip_invisible(next_of(snap.list->m_head, 0));
+            }
+
+            // positions on the first visible entry >= target
+            void seek(const T &target) {
+                Node *cur = snap.list->m_head;
+                for (int level = P - 1; level >= 0; --level) {
+                    Node *next;
+                    while ((next = next_of(cur, level)) && next->value.value() < target) {
+                        cur = next;
+                    }
+                }
+                node = skip_invisible(next_of(cur, 0));
+            }
+
+        private:
+            Node* skip_invisible(Node *n) const noexcept {
+                while (n && !n->visible_at(snap.m_version)) {
+                    n = next_of(n, 0);
+                }
+                return n;
+            }
+
+            const snapshot_handle &snap;
+            Node *node;
+        };
+
+        snapshot_handle(snapshot_handle &&other) noexcept : list(other.list), m_version(other.m_version) {
+            other.list = nullptr;
+        }
+
+        snapshot_handle& operator=(snapshot_handle&&) = delete;
+        snapshot_handle(const snapshot_handle&) = delete;
+
+        ~snapshot_handle() {
+            if (list) {
+                list->release_snapshot(m_version);
             }
-            update[level] = cur;
         }
 
-        auto newNode = new Node(num);
-        for (int level = 0; level < P; ++level) {
-            newNode->next[level] = update[level]->next[level];
-            update[level]->next[level] = newNode;
-            if (!random_level_check()) break;
+        bool contains(const T &target) const {
+            iterator it(*this);
+            it.seek(target);
+            return it.valid() && it.value() == target;
         }
-    }
 
-    bool erase(T num) {
+        uint64_t version() const noexcept {
+            return m_version;
+        }
+
+    private:
+        friend class Skiplist;
+
+        snapshot_handle(Skiplist *l, uint64_t version) noexcept : list(l), m_version(version) {}
+
+        Skiplist *list;
+        uint64_t m_version;
+    };
+
+    snapshot_handle snapshot() {
         std::lock_guard<std::mutex> lock(mtx);
-        std::vector<Node*> update(P, nullptr);
-        auto cur = m_head;
+        m_snapshots.insert(m_version);
+        return snapshot_handle(this, m_version);
+    }
 
-        for (int level = P - 1; level >= 0; --level) {
-            while (cur->next[level] && cur->next[level]->value.value() < num) {
-                cur = cur->next[level];
+    // Builds the list from `count` keys in non-decreasing order, taken one
+    // at a time from next(), by appending at the tail of every level with
+    // no searches. Heights come from the key's index rather than the RNG:
+    // node i gets one level per trailing zero bit of i + 1, the same 1/2
+    // per level as random_height() but evenly spread. The chain is built
+    // off to the side in its own arena and linked in only once complete,
+    // so snapshots never see a partial load. Returns false, leaving the
+    // list untouched and the arena freed, if the list is not empty or a
+    // key is out of order. load_from in skiplist_io.hpp is built on this.
+    template <typename Next>
+    bool append_sorted(uint64_t count, Next &&next) {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (next_of(m_head, 0) != nullptr) {
+            return false;
+        }
+        std::unique_ptr<arena> bulk(new arena(bulk_block_size));
+        Node *first = Node::create(P);
+        Node *tail[P];
+        std::fill(tail, tail + P, first);
+        uint64_t version = m_version + 1;
+        bool ok = true;
+        for (uint64_t i = 0; i < count; ++i) {
+            T value = next();
+            if (i > 0 && value < tail[0]->value.value()) {
+                ok = false;
+                break;
+            }
+            int height = std::min(P, __builtin_ctzll(i + 1) + 1);
+            auto newNode = Node::create(height, std::move(value), version, bulk.get());
+            for (int level = 0; level < height; ++level) {
+                tail[level]->next[level].store(newNode, std::memory_order_relaxed);
+                tail[level] = newNode;
+            }
+        }
+        if (ok) {
+            m_version = version;
+            for (int level = 0; level < P; ++level) {
+                m_head->next[level].store(next_of(first, level), std::memory_order_release);
+            }
+            m_bulk.push_back(std::move(bulk));
+        } else {
+            // never published, no snapshot can reach these
+            for (Node *n = next_of(first, 0); n; ) {
+                Node *next = next_of(n, 0);
+                Node::destroy(n);
+                n = next;
             }
-            update[level] = cur;
         }
+        Node::destroy(first);
+        return ok;
+    }
 
-        auto target = cur->next[0];
-        if (!target || !target->value.has_value() || target->value.value() != num) {
-            return false;
+    // Cursor for applying operations in non-decreasing key order. It keeps
+    // the predecessors of the previous key, so each search resumes from
+    // there instead of from the head. Only reachable through batch(), which
+    // holds the lock for the cursor's lifetime.
+    class finger {
+    public:
+        bool search(T target) {
+            seek(target);
+            return find_live(update.data(), target) != nullptr;
         }
 
-        for (int level = P - 1; level >= 0; --level) {
-            if (update[level]->next[level] == target) {
-                update[level]->next[level] = target->next[level];
+        void add(T num) {
+            seek(num);
+            list.link(update.data(), num);
+        }
+
+        bool erase(T num) {
+            seek(num);
+            return list.remove(update.data(), num);
+        }
+
+    private:
+        friend class Skiplist;
+
+        explicit finger(Skiplist &l) : list(l), update(P, l.m_head) {}
+
+        // update[level] becomes the last node before `key` on each level,
+        // starting from whichever of the old finger and the node reached
+        // on the level above is further along
+        void seek(const T &key) {
+            Node *cur = list.m_head;
+            for (int level = P - 1; level >= 0; --level) {
+                Node *prev = update[level];
+                if (cur == list.m_head || (prev != list.m_head && cur->value.value() < prev->value.value())) {
+                    cur = prev;
+                }
+                Node *next;
+                while ((next = next_of(cur, level)) && next->value.value() < key) {
+                    cur = next;
+                }
+                update[level] = cur;
             }
         }
-        delete target;
-        return true;
+
+        Skiplist &list;
+        std::vector<Node*> update;
+    };
+
+    // Runs f(finger&) under the lock. Operations on the finger must come in
+    // non-decreasing key order.
+    template <typename F>
+    void batch(F &&f) {
+        std::lock_guard<std::mutex> lock(mtx);
+        finger fg(*this);
+        f(fg);
     }
 
     friend std::ostream& operator<<(std::ostream& out, const Skiplist& list) {
-        auto cur = list.m_head->next[0];
+        auto cur = next_of(list.m_head, 0);
         while (cur) {
-            if (cur->value.has_value()) {
+            if (cur->value.has_value() && cur->is_live()) {
                 out << cur->value.value() << ' ';
             }
-            cur = cur->next[0];
+            cur = next_of(cur, 0);
         }
         return out;
     }
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <mutex>
+#include <optional>
+#include <utility>
 
 namespace multithreaded_ds {
 
@@ -10,7 +12,8 @@ private:
     struct Node {
         Node *next;
         T data;
-        Node(const T &init) : data(init), next(nullptr) {}
+        template <typename... Args>
+        Node(Args&&... args) : next(nullptr), data(std::forward<Args>(args)...) {}
     };
 
     // top of the stack
@@ -20,6 +23,13 @@ private:
     // lock of the stack
     std::mutex mtx;
 
+    void link(Node *new_node) noexcept {
+        std::lock_guard<std::mutex> lock(mtx);
+        new_node->next = top;
+        top = new_node;
+        stack_size++;
+    }
+
 public:
     concurrent_stack() noexcept : top(nullptr), stack_size(0) {}
     
@@ -28,11 +38,16 @@ public:
     }
 
     void push(const T& value) noexcept {
-        std::lock_guard<std::mutex> lock(mtx);
-        Node* new_node = new Node(value);
-        new_node->next = top;
-        top = new_node;
-        stack_size++;
+        link(new Node(value));
+    }
+
+    void push(T&& value) noexcept {
+        link(new Node(std::move(value)));
+    }
+
+    template <typename... Args>
+    void emplace(Args&&... args) noexcept {
+        link(new Node(std::forward<Args>(args)...));
     }
 
     bool pop(T& value) noexcept {
@@ -40,13 +55,28 @@ public:
         if (top == nullptr) return false;
         
         Node* old_top = top;
-        value = old_top->data;
+        value = std::move(old_top->data);
         top = old_top->next;
         delete old_top;
         stack_size--;
         return true;
     }
 
+    std::optional<T> pop() noexcept {
+        std::optional<T> res;
+        Node* old_top;
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            if (top == nullptr) return res;
+            old_top = top;
+            top = old_top->next;
+            stack_size--;
+        }
+        res.emplace(std::move(old_top->data));
+        delete old_top;
+        return res;
+    }
+
     bool isEmpty() noexcept {
         std::lock_guard<std::mutex> lock(mtx);
         return top == nullptr;
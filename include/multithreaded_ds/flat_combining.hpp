@@ -0,0 +1,214 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <utility>
+
+#include "concurrent_queue.hpp"
+#include "concurrent_skiplist.hpp"
+#include "concurrent_stack.hpp"
+#include "futex.hpp"
+#include "stats.hpp"
+
+namespace multithreaded_ds {
+
+// Flat combining (Hendler et al.): instead of every thread taking the lock
+// of the shared structure, each thread publishes its operation in its own
+// slot and spins. Whichever thread grabs the combiner flag applies all the
+// published operations in one go while the lock's cache line stays put.
+//
+// The Ops policy names the underlying structure and applies a batch, which
+// it may reorder freely since all operations in it are concurrent:
+//
+//     struct Ops {
+//         using structure = ...;
+//         using record = ...;
+//         static void apply(structure&, record** batch, size_t n);
+//     };
+//
+// Ready-made policies for concurrent_stack, concurrent_queue and Skiplist
+// live in the fc namespace below. Their structures keep their own mutex,
+// which is only ever taken by the combiner and so never contended.
+template <typename Ops, size_t Slots = 64>
+class flat_combining {
+public:
+    using structure = typename Ops::structure;
+    using record = typename Ops::record;
+
+    template <typename... Args>
+    explicit flat_combining(Args&&... args) : ds(std::forward<Args>(args)...) {}
+
+    flat_combining(const flat_combining&) = delete;
+    flat_combining& operator=(const flat_combining&) = delete;
+
+    // Applies `rec` to the structure and returns it with its result filled in.
+    record execute(record rec) {
+        request req{&rec};
+        slot &s = slots[thread_slot() % Slots];
+        bool published = false;
+        for (unsigned spins = 0; ; ++spins) {
+            if (!published) {
+                request *expected = nullptr;
+                published = s.pending.compare_exchange_strong(expected, &req, std::memory_order_release,
+                                                              std::memory_order_relaxed);
+            }
+            if (published && req.done.load(std::memory_order_acquire)) {
+                return rec;
+            }
+            if (!combining.load(std::memory_order_relaxed) &&
+                !combining.exchange(true, std::memory_order_acquire)) {
+                combine();
+                combining.store(false, std::memory_order_release);
+                continue;
+            }
+            if (spins < 64) {
+                cpu_relax();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    // direct access, only safe while no other thread is executing operations
+    structure& underlying() noexcept {
+        return ds;
+    }
+
+private:
+    struct request {
+        record *rec;
+        std::atomic<bool> done{false};
+    };
+
+    struct alignas(stats::cache_line_size) slot {
+        std::atomic<request*> pending{nullptr};
+    };
+
+    static size_t thread_slot() noexcept {
+        static std::atomic<size_t> next_slot{0};
+        thread_local size_t index = next_slot.fetch_add(1, std::memory_order_relaxed);
+        return index;
+    }
+
+    void combine() {
+        request *taken[Slots];
+        record *batch[Slots];
+        size_t n = 0;
+        for (auto &s : slots) {
+            if (s.pending.load(std::memory_order_relaxed) == nullptr) continue;
+            request *req = s.pending.exchange(nullptr, std::memory_order_acquire);
+            if (req) {
+                taken[n] = req;
+                batch[n] = req->rec;
+                ++n;
+            }
+        }
+        if (n == 0) return;
+        Ops::apply(ds, batch, n);
+        for (size_t i = 0; i < n; ++i) {
+            taken[i]->done.store(true, std::memory_order_release);
+        }
+    }
+
+    alignas(stats::cache_line_size) std::atomic<bool> combining{false};
+    slot slots[Slots];
+    structure ds;
+};
+
+namespace fc {
+
+enum class op { push, pop, add, erase, search };
+
+// Operation record shared by the policies below. `result` reports whether
+// a pop found an element or whether add/erase/search succeeded.
+template <typename T>
+struct record {
+    op kind;
+    T value{};
+    bool result = false;
+};
+
+template <typename T>
+struct stack_ops {
+    using structure = concurrent_stack<T>;
+    using record = fc::record<T>;
+
+    // pushes and pops in the same batch cancel out without touching the
+    // stack (a pop linearised right after the push it takes from)
+    static void apply(structure &s, record** batch, size_t n) {
+        size_t pushes = 0;
+        for (size_t i = 0; i < n; ++i) {
+            record *r = batch[i];
+            if (r->kind == op::push) {
+                std::swap(batch[pushes++], batch[i]);
+            }
+        }
+        size_t pending = pushes;
+        for (size_t i = pushes; i < n; ++i) {
+            record *r = batch[i];
+            if (pending > 0) {
+                r->value = std::move(batch[--pending]->value);
+                r->result = true;
+                batch[pending]->result = true;
+            } else {
+                r->result = s.pop(r->value);
+            }
+        }
+        for (size_t i = 0; i < pending; ++i) {
+            s.push(std::move(batch[i]->value));
+            batch[i]->result = true;
+        }
+    }
+};
+
+template <typename T>
+struct queue_ops {
+    using structure = concurrent_queue<T>;
+    using record = fc::record<T>;
+
+    static void apply(structure &q, record** batch, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            record *r = batch[i];
+            if (r->kind == op::push) {
+                r->result = q.push(std::move(r->value));
+            } else {
+                r->result = q.pop(r->value);
+            }
+        }
+    }
+};
+
+// Sorts the batch by key and applies it in one pass with a finger, so the
+// whole batch costs about one search plus the distance between keys.
+template <typename T, int P = 20>
+struct skiplist_ops {
+    using structure = Skiplist<T, P>;
+    using record = fc::record<T>;
+
+    static void apply(structure &list, record** batch, size_t n) {
+        std::sort(batch, batch + n, [](const record *a, const record *b) { return a->value < b->value; });
+        list.batch([&](typename structure::finger &fg) {
+            for (size_t i = 0; i < n; ++i) {
+                record *r = batch[i];
+                switch (r->kind) {
+                    case op::add:
+                        fg.add(r->value);
+                        r->result = true;
+                        break;
+                    case op::erase:
+                        r->result = fg.erase(r->value);
+                        break;
+                    default:
+                        r->result = fg.search(r->value);
+                        break;
+                }
+            }
+        });
+    }
+};
+
+}  // namespace fc
+
+}  // namespace multithreaded_ds
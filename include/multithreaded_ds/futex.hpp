@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <climits>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace multithreaded_ds {
+
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#else
+    std::this_thread::yield();
+#endif
+}
+
+// Thin wrappers over the Linux futex syscall. `shared` selects the
+// cross-process variant for words living in shared memory. On other
+// platforms waiting degrades to a short sleep, which is correct because
+// every caller re-checks its condition in a loop.
+
+// Blocks while `word` still holds `expected`, at most for `timeout` if given.
+// Returns false if the timeout expired.
+inline bool futex_wait(std::atomic<uint32_t> &word, uint32_t expected,
+                       const std::chrono::nanoseconds *timeout = nullptr, bool shared = false) noexcept {
+#if defined(__linux__)
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex word must be 32 bits");
+    timespec ts;
+    timespec *pts = nullptr;
+    if (timeout) {
+        auto ns = timeout->count() > 0 ? timeout->count() : 0;
+        ts.tv_sec = static_cast<time_t>(ns / 1000000000);
+        ts.tv_nsec = static_cast<long>(ns % 1000000000);
+        pts = &ts;
+    }
+    int op = shared ? FUTEX_WAIT : FUTEX_WAIT_PRIVATE;
+    long rc = syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), op, expected, pts, nullptr, 0);
+    return !(rc == -1 && errno == ETIMEDOUT);
+#else
+    (void)shared;
+    if (word.load(std::memory_order_acquire) != expected) return true;
+    auto nap = std::chrono::microseconds(50);
+    if (timeout && *timeout < nap) {
+        std::this_thread::sleep_for(*timeout);
+        return word.load(std::memory_order_acquire) != expected;
+    }
+    std::this_thread::sleep_for(nap);
+    return true;
+#endif
+}
+
+inline void futex_wake(std::atomic<uint32_t> &word, int count, bool shared = false) noexcept {
+#if defined(__linux__)
+    int op = shared ? FUTEX_WAKE : FUTEX_WAKE_PRIVATE;
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), op, count, nullptr, nullptr, 0);
+#else
+    (void)word; (void)count; (void)shared;
+#endif
+}
+
+inline void futex_wake_all(std::atomic<uint32_t> &word, bool shared = false) noexcept {
+#if defined(__linux__)
+    futex_wake(word, INT_MAX, shared);
+#else
+    futex_wake(word, 0, shared);
+#endif
+}
+
+}  // namespace multithreaded_ds
@@ -0,0 +1,18 @@
+#pragma once
+
+namespace multithreaded_ds {
+
+// Link embedded in user objects for the intrusive containers. Derive from
+// it to make a type linkable; objects that must sit in several containers
+// at once derive from one hook per container, told apart by Tag.
+//
+//     struct message : multithreaded_ds::intrusive_hook<> { ... };
+//
+// The containers never allocate, copy or free the objects: the caller owns
+// them and must keep them alive while they are linked.
+template <typename Tag = void>
+struct intrusive_hook {
+    intrusive_hook *next = nullptr;
+};
+
+}  // namespace multithreaded_ds
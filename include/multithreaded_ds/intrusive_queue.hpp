@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <type_traits>
+
+#include "intrusive_hook.hpp"
+#include "stats.hpp"
+
+namespace multithreaded_ds {
+
+// FIFO queue that links objects through their embedded hook instead of
+// copying them into freshly allocated nodes.
+template <typename T, typename Tag = void>
+class intrusive_queue {
+private:
+    using hook = intrusive_hook<Tag>;
+    static_assert(std::is_base_of<hook, T>::value, "T must derive from intrusive_hook<Tag>");
+
+    // front of the queue
+    hook *front;
+    // back of the queue
+    hook *back;
+    // size of the queue
+    size_t queue_size;
+    // lock of the queue
+    std::mutex mtx;
+    // instrumentation, empty unless MULTITHREADED_DS_ENABLE_STATS is set
+    stats::counters<stats::queue_counter> m_stats;
+
+    using lock_guard = stats::timed_lock_guard<std::mutex, stats::queue_counter>;
+
+    static T* owner(hook *h) noexcept {
+        return static_cast<T*>(h);
+    }
+
+public:
+    intrusive_queue() noexcept : front(nullptr), back(nullptr), queue_size(0) {}
+
+    // only unlinks, the objects belong to the caller
+    ~intrusive_queue() noexcept {
+        clear();
+    }
+
+    intrusive_queue(const intrusive_queue&) = delete;
+    intrusive_queue& operator=(const intrusive_queue&) = delete;
+
+    void push(T& item) noexcept {
+        hook *h = &item;
+        h->next = nullptr;
+        lock_guard lock(mtx, m_stats);
+        if (back == nullptr) {
+            front = back = h;
+        } else {
+            back->next = h;
+            back = h;
+        }
+        queue_size++;
+        m_stats.add(stats::queue_counter::pushes);
+        m_stats.update_max(stats::queue_counter::max_depth, queue_size);
+    }
+
+    // returns nullptr when the queue is empty
+    T* pop() noexcept {
+        lock_guard lock(mtx, m_stats);
+        if (front == nullptr) {
+            return nullptr;
+        }
+        hook *old_front = front;
+        front = old_front->next;
+        if (front == nullptr) {
+            back = nullptr;
+        }
+        old_front->next = nullptr;
+        queue_size--;
+        m_stats.add(stats::queue_counter::pops);
+        return owner(old_front);
+    }
+
+    T* peek() noexcept {
+        lock_guard lock(mtx, m_stats);
+        return front ? owner(front) : nullptr;
+    }
+
+    bool isEmpty() noexcept {
+        lock_guard lock(mtx, m_stats);
+        return front == nullptr;
+    }
+
+    size_t size() noexcept {
+        lock_guard lock(mtx, m_stats);
+        return queue_size;
+    }
+
+    void clear() noexcept {
+        lock_guard lock(mtx, m_stats);
+        while (front != nullptr) {
+            hook *old_front = front;
+            front = old_front->next;
+            old_front->next = nullptr;
+        }
+        back = nullptr;
+        queue_size = 0;
+    }
+
+    stats::queue_snapshot stats() const noexcept {
+        using c = stats::queue_counter;
+        stats::queue_snapshot res;
+        res.pushes = m_stats.sum(c::pushes);
+        res.pops = m_stats.sum(c::pops);
+        res.lock_acquisitions = m_stats.sum(c::lock_acquisitions);
+        res.lock_wait_ns = m_stats.sum(c::lock_wait_ns);
+        res.lock_hold_ns = m_stats.sum(c::lock_hold_ns);
+        res.max_depth = m_stats.max(c::max_depth);
+        return res;
+    }
+};
+
+}  // namespace multithreaded_ds
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <type_traits>
+
+#include "intrusive_hook.hpp"
+
+namespace multithreaded_ds {
+
+// LIFO stack that links objects through their embedded hook instead of
+// copying them into freshly allocated nodes.
+template <typename T, typename Tag = void>
+class intrusive_stack {
+private:
+    using hook = intrusive_hook<Tag>;
+    static_assert(std::is_base_of<hook, T>::value, "T must derive from intrusive_hook<Tag>");
+
+    // top of the stack
+    hook *top;
+    // size of the stack
+    size_t stack_size;
+    // lock of the stack
+    std::mutex mtx;
+
+public:
+    intrusive_stack() noexcept : top(nullptr), stack_size(0) {}
+
+    // only unlinks, the objects belong to the caller
+    ~intrusive_stack() noexcept {
+        clear();
+    }
+
+    intrusive_stack(const intrusive_stack&) = delete;
+    intrusive_stack& operator=(const intrusive_stack&) = delete;
+
+    void push(T& item) noexcept {
+        hook *h = &item;
+        std::lock_guard<std::mutex> lock(mtx);
+        h->next = top;
+        top = h;
+        stack_size++;
+    }
+
+    // returns nullptr when the stack is empty
+    T* pop() noexcept {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (top == nullptr) return nullptr;
+
+        hook *old_top = top;
+        top = old_top->next;
+        old_top->next = nullptr;
+        stack_size--;
+        return static_cast<T*>(old_top);
+    }
+
+    T* peek() noexcept {
+        std::lock_guard<std::mutex> lock(mtx);
+        return top ? static_cast<T*>(top) : nullptr;
+    }
+
+    bool isEmpty() noexcept {
+        std::lock_guard<std::mutex> lock(mtx);
+        return top == nullptr;
+    }
+
+    size_t size() noexcept {
+        std::lock_guard<std::mutex> lock(mtx);
+        return stack_size;
+    }
+
+    void clear() noexcept {
+        std::lock_guard<std::mutex> lock(mtx);
+        while (top != nullptr) {
+            hook *old_top = top;
+            top = old_top->next;
+            old_top->next = nullptr;
+        }
+        stack_size = 0;
+    }
+};
+
+}  // namespace multithreaded_ds
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <random>
+#include <string_view>
+#include <utility>
+
+#include "arena.hpp"
+
+namespace multithreaded_ds {
+
+// Three-way byte-wise comparison, the default memtable ordering.
+struct bytewise_comparator {
+    int operator()(std::string_view a, std::string_view b) const noexcept {
+        return a.compare(b);
+    }
+};
+
+// Skiplist write buffer modelled on LevelDB's memtable.
+//
+// Nodes, keys and values are bump-allocated from a per-table arena and
+// released together when the table is destroyed; nothing is ever erased.
+// Writers are serialised by `write_mtx`, readers take no lock at all:
+// a node is fully built before it is published with a release store, and
+// nodes are never freed while the table is alive.
+//
+// Compare is a three-way comparator over std::string_view returning <0, 0
+// or >0. Keys are unique; add() refuses a key that is already present.
+template <typename Compare = bytewise_comparator, int P = 12>
+class memtable {
+private:
+    // key and value bytes follow the `height` links in the same allocation
+    struct Node {
+        uint32_t key_size;
+        uint32_t value_size;
+        uint32_t height;
+        std::atomic<Node*> next[1];
+
+        const char* data() const noexcept {
+            return reinterpret_cast<const char*>(&next[height]);
+        }
+
+        std::string_view key() const noexcept {
+            return std::string_view(data(), key_size);
+        }
+
+        std::string_view value() const noexcept {
+            return std::string_view(data() + key_size, value_size);
+        }
+    };
+
+    arena m_arena;
+    Compare comp;
+    Node *m_head;
+    // highest level in use, read without the lock
+    std::atomic<int> max_height;
+    std::atomic<size_t> m_count;
+    std::mutex write_mtx;
+    std::mt19937 rng{0xdeadbeef};
+
+    // LevelDB uses a branching factor of 4 rather than Skiplist's 2
+    int random_height() {
+        int height = 1;
+        while (height < P && rng() % 4 == 0) ++height;
+        return height;
+    }
+
+    Node* new_node(std::string_view key, std::string_view value, int height) {
+        size_t bytes = sizeof(Node) + (height - 1) * sizeof(std::atomic<Node*>) + key.size() + value.size();
+        void *mem = m_arena.allocate_aligned(bytes, alignof(Node));
+        Node *n = static_cast<Node*>(mem);
+        n->key_size = static_cast<uint32_t>(key.size());
+        n->value_size = static_cast<uint32_t>(value.size());
+        n->height = static_cast<uint32_t>(height);
+        for (int level = 0; level < height; ++level) {
+            new(&n->next[level]) std::atomic<Node*>(nullptr);
+        }
+        char *data = const_cast<char*>(n->data());
+        if (!key.empty()) std::memcpy(data, key.data(), key.size());
+        if (!value.empty()) std::memcpy(data + key.size(), value.data(), value.size());
+        return n;
+    }
+
+    // first node with key >= `key`; fills prev[] with predecessors if given
+    Node* find_greater_or_equal(std::string_view key, Node **prev) const {
+        Node *cur = m_head;
+        int level = max_height.load(std::memory_order_relaxed) - 1;
+        while (true) {
+            Node *next = cur->next[level].load(std::memory_order_acquire);
+            if (next && comp(next->key(), key) < 0) {
+                cur = next;
+                continue;
+            }
+            if (prev) prev[level] = cur;
+            if (level == 0) return next;
+            --level;
+        }
+    }
+
+public:
+    // Forward iterator over a live table. Entries added after the iterator
+    // was positioned may or may not be seen.
+    class iterator {
+    public:
+        explicit iterator(const memtable &t) noexcept : table(t), node(nullptr) {}
+
+        bool valid() const noexcept { return node != nullptr; }
+        std::string_view key() const noexcept { return node->key(); }
+        std::string_view value() const noexcept { return node->value(); }
+
+        void next() noexcept {
+            node = node->next[0].load(std::memory_order_acquire);
+        }
+
+        void seek(std::string_view target) {
+            node = table.find_greater_or_equal(target, nullptr);
+        }
+
+        void seek_to_first() noexcept {
+            node = table.m_head->next[0].load(std::memory_order_acquire);
+        }
+
+    private:
+        const memtable &table;
+        Node *node;
+    };
+
+    explicit memtable(Compare c = Compare()) : comp(std::move(c)), max_height(1), m_count(0) {
+        m_head = new_node(std::string_view(), std::string_view(), P);
+    }
+
+    memtable(const memtable&) = delete;
+    memtable& operator=(const memtable&) = delete;
+
+    // Copies key and value into the arena. Returns false if the key exists.
+    bool add(std::string_view key, std::string_view value = std::string_view()) {
+        std::lock_guard<std::mutex> lock(write_mtx);
+        Node *prev[P];
+        Node *found = find_greater_or_equal(key, prev);
+        if (found && comp(found->key(), key) == 0) {
+            return false;
+        }
+
+        int height = random_height();
+        int cur_height = max_height.load(std::memory_order_relaxed);
+        if (height > cur_height) {
+            for (int level = cur_height; level < height; ++level) {
+                prev[level] = m_head;
+            }
+            // readers seeing the new height before the links just find
+            // nullptr from the head on the new levels, which is fine
+            max_height.store(height, std::memory_order_relaxed);
+        }
+
+        Node *n = new_node(key, value, height);
+        for (int level = 0; level < height; ++level) {
+            n->next[level].store(prev[level]->next[level].load(std::memory_order_relaxed),
+                                 std::memory_order_relaxed);
+            prev[level]->next[level].store(n, std::memory_order_release);
+        }
+        m_count.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool contains(std::string_view key) const {
+        Node *n = find_greater_or_equal(key, nullptr);
+        return n && comp(n->key(), key) == 0;
+    }
+
+    // the view stays valid for the lifetime of the table
+    std::optional<std::string_view> get(std::string_view key) const {
+        Node *n = find_greater_or_equal(key, nullptr);
+        if (n && comp(n->key(), key) == 0) {
+            return n->value();
+        }
+        return std::nullopt;
+    }
+
+    size_t size() const noexcept {
+        return m_count.load(std::memory_order_relaxed);
+    }
+
+    // arena bytes in use, meant as the flush trigger
+    size_t memory_usage() const noexcept {
+        return m_arena.memory_usage();
+    }
+};
+
+}  // namespace multithreaded_ds
@@ -0,0 +1,390 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "futex.hpp"
+#include "stats.hpp"
+
+namespace multithreaded_ds {
+
+// Preallocated multicast ring in the style of the LMAX Disruptor. Every
+// consumer sees every event; events live in the ring's slots and are never
+// copied or allocated per consumer.
+//
+// Positions are 64-bit sequence numbers, slot = sequence & (capacity - 1).
+// Producers claim a range of sequences from the sequencer, fill the slots
+// and publish the range. Each consumer owns a cursor (the last sequence it
+// has finished with) and reads up to what its barrier allows: the
+// published cursor, or for a downstream stage the minimum cursor of the
+// consumers it depends on. Producers never overtake the slowest consumer.
+//
+// Consumers are registered with add_consumer() before anything is
+// published. Wait strategies decide what an idle producer or consumer does,
+// from busy_spin_wait (lowest latency, burns a core) to blocking_wait
+// (sleeps on a futex, producers only pay a syscall when someone sleeps).
+
+// cursor padded to its own cache line
+struct alignas(stats::cache_line_size) ring_sequence {
+    std::atomic<int64_t> value{-1};
+
+    int64_t load() const noexcept { return value.load(std::memory_order_acquire); }
+    void store(int64_t v) noexcept { value.store(v, std::memory_order_release); }
+};
+
+// Wait strategies: wait(ready) returns once ready() is true, signal() is
+// called after every publish and every consumer release.
+
+struct busy_spin_wait {
+    template <typename Ready>
+    void wait(Ready ready) noexcept {
+        while (!ready()) {
+            cpu_relax();
+        }
+    }
+    void signal() noexcept {}
+};
+
+struct yielding_wait {
+    static constexpr unsigned spin_limit = 100;
+
+    template <typename Ready>
+    void wait(Ready ready) noexcept {
+        for (unsigned spins = 0; !ready(); ++spins) {
+            if (spins < spin_limit) {
+                cpu_relax();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+    void signal() noexcept {}
+};
+
+// spins, then yields a few times, then sleeps on a futex
+class blocking_wait {
+public:
+    static constexpr unsigned spin_limit = 256;
+    static constexpr unsigned yield_limit = 16;
+
+    template <typename Ready>
+    void wait(Ready ready) noexcept {
+        for (unsigned spins = 0; spins < spin_limit + yield_limit; ++spins) {
+            if (ready()) {
+                return;
+            }
+            if (spins < spin_limit) {
+                cpu_relax();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        while (true) {
+            // registered before the last check, so a signal after it sees us
+            m_sleepers.fetch_add(1, std::memory_order_seq_cst);
+            uint32_t seq = m_signal.load(std::memory_order_seq_cst);
+            if (ready()) {
+                m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+                return;
+            }
+            futex_wait(m_signal, seq);
+            m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+            if (ready()) {
+                return;
+            }
+        }
+    }
+
+    void signal() noexcept {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_sleepers.load(std::memory_order_seq_cst) != 0) {
+            m_signal.fetch_add(1, std::memory_order_seq_cst);
+            futex_wake_all(m_signal);
+        }
+    }
+
+private:
+    std::atomic<uint32_t> m_signal{0};
+    std::atomic<uint32_t> m_sleepers{0};
+};
+
+// Sequencers. next(n, gate) claims n sequences and returns the highest,
+// calling gate(wrap_point) to wait until the slowest consumer is past the
+// slots about to be reused. highest_published(lo, hi) is the last sequence
+// in [lo, hi] consumers may read, given that the cursor says hi.
+
+// one producer thread, claims are plain arithmetic
+class single_producer {
+public:
+    explicit single_producer(size_t capacity) : m_capacity(capacity) {}
+
+    template <typename Gate>
+    int64_t next(size_t n, Gate &&gate) {
+        int64_t hi = m_next + static_cast<int64_t>(n);
+        int64_t wrap = hi - static_cast<int64_t>(m_capacity);
+        if (wrap > m_cached_gate) {
+            m_cached_gate = gate(wrap);
+        }
+        m_next = hi;
+        return hi;
+    }
+
+    void publish(int64_t, int64_t hi) noexcept { m_cursor.store(hi); }
+
+    int64_t highest_published(int64_t, int64_t hi) const noexcept { return hi; }
+
+    const ring_sequence& cursor() const noexcept { return m_cursor; }
+
+private:
+    size_t m_capacity;
+    int64_t m_next = -1;
+    // slowest consumer as of the last time we had to look
+    int64_t m_cached_gate = -1;
+    ring_sequence m_cursor;
+};
+
+// Any number of producer threads. Claims are a fetch_add on the cursor;
+// since ranges are published out of order, each slot records the lap it
+// was last published in and readers stop at the first gap.
+class multi_producer {
+public:
+    explicit multi_producer(size_t capacity) :
+    m_capacity(capacity),
+    m_shift(0),
+    m_available(new std::atomic<int32_t>[capacity]) {
+        while ((size_t(1) << m_shift) < capacity) ++m_shift;
+        for (size_t i = 0; i < capacity; ++i) {
+            m_available[i].store(-1, std::memory_order_relaxed);
+        }
+    }
+
+    template <typename Gate>
+    int64_t next(size_t n, Gate &&gate) {
+        int64_t hi = m_cursor.value.fetch_add(static_cast<int64_t>(n), std::memory_order_acq_rel) + static_cast<int64_t>(n);
+        int64_t wrap = hi - static_cast<int64_t>(m_capacity);
+        // acquire/release: a producer trusting a value another producer
+        // cached must also see the consumers' releases behind it before
+        // overwriting those slots
+        if (wrap > m_cached_gate.load(std::memory_order_acquire)) {
+            m_cached_gate.store(gate(wrap), std::memory_order_release);
+        }
+        return hi;
+    }
+
+    void publish(int64_t lo, int64_t hi) noexcept {
+        for (int64_t s = lo; s <= hi; ++s) {
+            m_available[s & (m_capacity - 1)].store(lap(s), std::memory_order_release);
+        }
+    }
+
+    int64_t highest_published(int64_t lo, int64_t hi) const noexcept {
+        for (int64_t s = lo; s <= hi; ++s) {
+            if (m_available[s & (m_capacity - 1)].load(std::memory_order_acquire) != lap(s)) {
+                return s - 1;
+            }
+        }
+        return hi;
+    }
+
+    // claimed, not necessarily published
+    const ring_sequence& cursor() const noexcept { return m_cursor; }
+
+private:
+    int32_t lap(int64_t s) const noexcept { return static_cast<int32_t>(s >> m_shift); }
+
+    size_t m_capacity;
+    unsigned m_shift;
+    std::unique_ptr<std::atomic<int32_t>[]> m_available;
+    ring_sequence m_cursor;
+    alignas(stats::cache_line_size) std::atomic<int64_t> m_cached_gate{-1};
+};
+
+template <typename T, typename Sequencer = single_producer, typename Wait = blocking_wait>
+class multicast_ring {
+public:
+    class consumer {
+    public:
+        // last sequence this consumer has released
+        int64_t position() const noexcept { return m_cursor.load(); }
+
+    private:
+        friend class multicast_ring;
+
+        ring_sequence m_cursor;
+        // cursors of upstream consumers, empty for a first stage
+        std::vector<const ring_sequence*> m_deps;
+    };
+
+    // capacity is rounded up to a power of two
+    explicit multicast_ring(size_t capacity) :
+    m_capacity(round_capacity(capacity)),
+    m_slots(new T[m_capacity]),
+    m_sequencer(m_capacity),
+    m_halted(false) {
+
+    }
+
+    multicast_ring(const multicast_ring&) = delete;
+    multicast_ring& operator=(const multicast_ring&) = delete;
+
+    // New consumer that only sees an event once every consumer in `deps`
+    // has released it (stage B after stage A). The ring owns the consumer.
+    consumer& add_consumer(std::initializer_list<const consumer*> deps = {}) {
+        m_consumers.emplace_back(new consumer());
+        consumer &c = *m_consumers.back();
+        for (auto d : deps) {
+            c.m_deps.push_back(&d->m_cursor);
+        }
+        c.m_cursor.store(m_sequencer.cursor().load());
+        return c;
+    }
+
+    // Producer side: claim n slots, fill ring[seq] for each, then publish
+    // the same range. Returns the highest claimed sequence, the range is
+    // [hi - n + 1, hi]. Blocks while the ring is full.
+    int64_t claim(size_t n = 1) {
+        assert(n >= 1 && n <= m_capacity);
+        return m_sequencer.next(n, [this](int64_t wrap) { return wait_gate(wrap); });
+    }
+
+    void publish(int64_t lo, int64_t hi) noexcept {
+        m_sequencer.publish(lo, hi);
+        m_wait.signal();
+    }
+
+    void publish(int64_t seq) noexcept { publish(seq, seq); }
+
+    T& operator[](int64_t seq) noexcept { return m_slots[seq & (m_capacity - 1)]; }
+    const T& operator[](int64_t seq) const noexcept { return m_slots[seq & (m_capacity - 1)]; }
+
+    // claims n slots, calls fill(slot, seq) for each and publishes them together
+    template <typename F>
+    void publish_events(size_t n, F &&fill) {
+        int64_t hi = claim(n);
+        int64_t lo = hi - static_cast<int64_t>(n) + 1;
+        for (int64_t s = lo; s <= hi; ++s) {
+            fill((*this)[s], s);
+        }
+        publish(lo, hi);
+    }
+
+    template <typename F>
+    void publish_event(F &&fill) {
+        publish_events(1, std::forward<F>(fill));
+    }
+
+    // Consumer side: highest sequence >= seq that c may read, blocking
+    // until there is one. Returns less than seq only once halted.
+    int64_t wait_for(const consumer &c, int64_t seq) {
+        int64_t res = available(c, seq);
+        if (res >= seq) {
+            return res;
+        }
+        m_wait.wait([&]() {
+            res = available(c, seq);
+            return res >= seq || m_halted.load(std::memory_order_acquire);
+        });
+        return res;
+    }
+
+    // c is done with every sequence up to and including seq
+    void release(consumer &c, int64_t seq) noexcept {
+        c.m_cursor.store(seq);
+        m_wait.signal();
+    }
+
+    // Waits for at least one event, then hands the whole available batch
+    // to handler(slot, seq, end_of_batch) and releases it in one step.
+    // Returns the batch size, 0 once halted.
+    template <typename F>
+    size_t consume(consumer &c, F &&handler) {
+        int64_t next = c.position() + 1;
+        int64_t hi = wait_for(c, next);
+        return hi < next ? 0 : process(c, next, hi, handler);
+    }
+
+    // consume() that returns 0 instead of waiting
+    template <typename F>
+    size_t try_consume(consumer &c, F &&handler) {
+        int64_t next = c.position() + 1;
+        int64_t hi = available(c, next);
+        return hi < next ? 0 : process(c, next, hi, handler);
+    }
+
+    // Wakes every waiting consumer and makes wait_for/consume return
+    // without an event from now on. Producers are not affected.
+    void halt() noexcept {
+        m_halted.store(true, std::memory_order_release);
+        m_wait.signal();
+    }
+
+    bool halted() const noexcept { return m_halted.load(std::memory_order_acquire); }
+
+    size_t capacity() const noexcept { return m_capacity; }
+
+private:
+    static size_t round_capacity(size_t capacity) noexcept {
+        size_t res = 1;
+        while (res < capacity) res <<= 1;
+        return res;
+    }
+
+    int64_t available(const consumer &c, int64_t seq) const noexcept {
+        if (c.m_deps.empty()) {
+            return m_sequencer.highest_published(seq, m_sequencer.cursor().load());
+        }
+        int64_t res = std::numeric_limits<int64_t>::max();
+        for (auto d : c.m_deps) {
+            res = std::min(res, d->load());
+        }
+        return res;
+    }
+
+    int64_t min_consumer() const noexcept {
+        int64_t res = std::numeric_limits<int64_t>::max();
+        for (auto &c : m_consumers) {
+            res = std::min(res, c->m_cursor.load());
+        }
+        return res;
+    }
+
+    // slowest consumer once it has passed wrap
+    int64_t wait_gate(int64_t wrap) {
+        int64_t res = min_consumer();
+        if (res >= wrap) {
+            return res;
+        }
+        m_wait.wait([&]() {
+            res = min_consumer();
+            return res >= wrap;
+        });
+        return res;
+    }
+
+    template <typename F>
+    size_t process(consumer &c, int64_t lo, int64_t hi, F &handler) {
+        for (int64_t s = lo; s <= hi; ++s) {
+            handler((*this)[s], s, s == hi);
+        }
+        release(c, hi);
+        return static_cast<size_t>(hi - lo + 1);
+    }
+
+    size_t m_capacity;
+    std::unique_ptr<T[]> m_slots;
+    Sequencer m_sequencer;
+    Wait m_wait;
+    std::vector<std::unique_ptr<consumer>> m_consumers;
+    std::atomic<bool> m_halted;
+};
+
+} // namespace multithreaded_ds
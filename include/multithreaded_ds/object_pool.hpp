@@ -0,0 +1,266 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "futex.hpp"
+#include "slab_allocator.hpp"
+#include "stats.hpp"
+
+namespace multithreaded_ds {
+
+// Typed pool with Bonwick-style magazines layered over slab pages.
+//
+//   cache   a handful of cache-line sized slots, each thread sticks to one;
+//           holds a loaded and a previous magazine and serves most calls
+//           without touching shared state
+//   depot   mutex-protected stock of full and empty magazines that the
+//           caches trade with when both of theirs run dry or fill up
+//   slabs   page-sized slabs (see slab) carved into blocks sized and
+//           aligned for T, used when the depot has nothing to give
+//
+// Each cache slot has its own tiny lock, so threads beyond the slot count
+// share slots instead of owning an unbounded number of caches; with one
+// thread per slot that lock is never contended.
+//
+// make() returns a unique_ptr whose deleter runs ~T and hands the block
+// back to the pool. The pool must outlive every handle.
+template <typename T, size_t MagazineSize = 32>
+class object_pool {
+private:
+    static constexpr size_t round_block_size() noexcept {
+        size_t need = std::max(sizeof(T), sizeof(void*));
+        size_t res = std::max(alignof(T), alignof(void*));
+        while (res < need) res <<= 1;
+        return res;
+    }
+
+public:
+    static constexpr size_t block_size = round_block_size();
+    static_assert(alignof(T) <= alignof(slab), "object_pool supports alignment up to a cache line");
+    static_assert(block_size <= slab::page_size, "object too large for a slab page");
+
+    struct deleter {
+        object_pool *pool;
+        void operator()(T *p) const noexcept {
+            pool->destroy(p);
+        }
+    };
+
+    using handle = std::unique_ptr<T, deleter>;
+
+    // at least 8 slots so a few oversubscribed threads still rarely share one
+    explicit object_pool(size_t cache_slots = std::max(8u, std::thread::hardware_concurrency())) {
+        size_t n = 1;
+        while (n < std::max<size_t>(cache_slots, 1)) n <<= 1;
+        cache_count = n;
+        caches.reset(new cache[n]);
+        for (size_t i = 0; i < n; ++i) {
+            caches[i].loaded = new magazine();
+            caches[i].previous = new magazine();
+        }
+    }
+
+    // every handle must have been released by now
+    ~object_pool() {
+        for (size_t i = 0; i < cache_count; ++i) {
+            delete caches[i].loaded;
+            delete caches[i].previous;
+        }
+        for (auto m : full_magazines) delete m;
+        for (auto m : empty_magazines) delete m;
+        for (auto s : all_slabs) s->destroy();
+    }
+
+    object_pool(const object_pool&) = delete;
+    object_pool& operator=(const object_pool&) = delete;
+
+    template <typename... Args>
+    handle make(Args&&... args) {
+        void *mem = allocate();
+        T *obj;
+        try {
+            obj = new(mem) T(std::forward<Args>(args)...);
+        } catch (...) {
+            deallocate(mem);
+            throw;
+        }
+        return handle(obj, deleter{this});
+    }
+
+    void destroy(T *p) noexcept {
+        p->~T();
+        deallocate(p);
+    }
+
+    // raw block of block_size bytes, for callers constructing T themselves
+    void* allocate() {
+        m_stats.add(stats::object_pool_counter::allocations);
+        cache &c = this_cache();
+        cache_lock lock(c);
+        if (c.loaded->count == 0) {
+            if (c.previous->count == MagazineSize) {
+                std::swap(c.loaded, c.previous);
+            } else {
+                std::lock_guard<std::mutex> depot_lock(depot_mtx);
+                if (full_magazines.empty()) {
+                    m_stats.add(stats::object_pool_counter::slab_allocations);
+                    return slab_allocate();
+                }
+                m_stats.add(stats::object_pool_counter::depot_exchanges);
+                empty_magazines.push_back(c.previous);
+                c.previous = c.loaded;
+                c.loaded = full_magazines.back();
+                full_magazines.pop_back();
+            }
+        }
+        return c.loaded->rounds[--c.loaded->count];
+    }
+
+    void deallocate(void *p) noexcept {
+        m_stats.add(stats::object_pool_counter::deallocations);
+        cache &c = this_cache();
+        cache_lock lock(c);
+        if (c.loaded->count == MagazineSize) {
+            if (c.previous->count == 0) {
+                std::swap(c.loaded, c.previous);
+            } else {
+                std::lock_guard<std::mutex> depot_lock(depot_mtx);
+                m_stats.add(stats::object_pool_counter::depot_exchanges);
+                full_magazines.push_back(c.previous);
+                c.previous = c.loaded;
+                if (empty_magazines.empty()) {
+                    c.loaded = new magazine();
+                } else {
+                    c.loaded = empty_magazines.back();
+                    empty_magazines.pop_back();
+                }
+            }
+        }
+        c.loaded->rounds[c.loaded->count++] = p;
+    }
+
+    // Returns the blocks of all full magazines in the depot to their slabs
+    // and releases slabs that end up completely free.
+    void trim() {
+        std::lock_guard<std::mutex> depot_lock(depot_mtx);
+        for (auto m : full_magazines) {
+            for (size_t i = 0; i < m->count; ++i) {
+                slab_free(m->rounds[i]);
+            }
+            m->count = 0;
+            empty_magazines.push_back(m);
+        }
+        full_magazines.clear();
+        for (auto m : empty_magazines) delete m;
+        empty_magazines.clear();
+    }
+
+    stats::object_pool_snapshot stats() const noexcept {
+        using c = stats::object_pool_counter;
+        stats::object_pool_snapshot res;
+        res.allocations = m_stats.sum(c::allocations);
+        res.deallocations = m_stats.sum(c::deallocations);
+        res.depot_exchanges = m_stats.sum(c::depot_exchanges);
+        res.slab_allocations = m_stats.sum(c::slab_allocations);
+        res.slab_frees = m_stats.sum(c::slab_frees);
+        return res;
+    }
+
+private:
+    // bounded LIFO of free blocks
+    struct magazine {
+        size_t count = 0;
+        void *rounds[MagazineSize];
+    };
+
+    struct alignas(stats::cache_line_size) cache {
+        std::atomic<bool> busy{false};
+        magazine *loaded = nullptr;
+        magazine *previous = nullptr;
+    };
+
+    class cache_lock {
+    public:
+        explicit cache_lock(cache &c) noexcept : m_cache(c) {
+            for (unsigned spins = 0; m_cache.busy.exchange(true, std::memory_order_acquire); ++spins) {
+                while (m_cache.busy.load(std::memory_order_relaxed)) {
+                    if (spins < 64) {
+                        cpu_relax();
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+        }
+        ~cache_lock() noexcept {
+            m_cache.busy.store(false, std::memory_order_release);
+        }
+    private:
+        cache &m_cache;
+    };
+
+    static size_t thread_slot() noexcept {
+        static std::atomic<size_t> next_slot{0};
+        thread_local size_t slot = next_slot.fetch_add(1, std::memory_order_relaxed);
+        return slot;
+    }
+
+    cache& this_cache() noexcept {
+        return caches[thread_slot() & (cache_count - 1)];
+    }
+
+    // slab layer, caller holds depot_mtx
+    void* slab_allocate() {
+        if (partial_slabs.empty()) {
+            slab *s = slab::create(block_size);
+            all_slabs.push_back(s);
+            partial_slabs.push_back(s);
+        }
+        slab *s = partial_slabs.back();
+        void *p = s->allocate();
+        if (s->empty()) {
+            partial_slabs.pop_back();
+        }
+        return p;
+    }
+
+    // caller holds depot_mtx
+    void slab_free(void *p) noexcept {
+        m_stats.add(stats::object_pool_counter::slab_frees);
+        slab *s = slab::owner(p);
+        bool was_empty = s->empty();
+        s->deallocate(p);
+        if (s->full()) {
+            if (!was_empty) {
+                partial_slabs.erase(std::find(partial_slabs.begin(), partial_slabs.end(), s));
+            }
+            all_slabs.erase(std::find(all_slabs.begin(), all_slabs.end(), s));
+            s->destroy();
+        } else if (was_empty) {
+            partial_slabs.push_back(s);
+        }
+    }
+
+    std::unique_ptr<cache[]> caches;
+    // cache_count is a power of two
+    size_t cache_count;
+
+    std::mutex depot_mtx;
+    std::vector<magazine*> full_magazines;
+    std::vector<magazine*> empty_magazines;
+    // slabs with at least one free block
+    std::vector<slab*> partial_slabs;
+    std::vector<slab*> all_slabs;
+
+    stats::counters<stats::object_pool_counter> m_stats;
+};
+
+}  // namespace multithreaded_ds
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "stats.hpp"
+
+namespace multithreaded_ds {
+
+// Multi-lane queue trading global FIFO order for throughput.
+//
+// Every producer thread is pinned to one lane, so elements pushed by the
+// same thread are popped in the order they were pushed (per-producer FIFO).
+// There is no ordering between elements of different producers: a consumer
+// drains its home lane first and then steals from the others round robin,
+// so an element pushed later on one lane may be popped before an earlier
+// element on another lane.
+template <typename T>
+class sharded_queue {
+private:
+    struct alignas(stats::cache_line_size) lane {
+        std::mutex mtx;
+        std::deque<T> items;
+        // read without the lock to skip empty lanes
+        std::atomic<size_t> size{0};
+    };
+
+    using lock_guard = stats::timed_lock_guard<std::mutex, stats::sharded_queue_counter>;
+
+    std::unique_ptr<lane[]> lanes;
+    // lane_count is a power of two
+    size_t lane_count;
+    stats::counters<stats::sharded_queue_counter> m_stats;
+
+    static size_t round_up_pow2(size_t n) noexcept {
+        size_t res = 1;
+        while (res < n) res <<= 1;
+        return res;
+    }
+
+    // per-thread id, assigned on first use and stable for the thread's lifetime
+    static size_t thread_slot() noexcept {
+        static std::atomic<size_t> next_slot{0};
+        thread_local size_t slot = next_slot.fetch_add(1, std::memory_order_relaxed);
+        return slot;
+    }
+
+    lane& home_lane() noexcept {
+        return lanes[thread_slot() & (lane_count - 1)];
+    }
+
+public:
+    explicit sharded_queue(size_t lanes_hint = std::thread::hardware_concurrency())
+        : lane_count(round_up_pow2(std::max<size_t>(lanes_hint, 1))) {
+        lanes.reset(new lane[lane_count]);
+    }
+
+    sharded_queue(const sharded_queue&) = delete;
+    sharded_queue& operator=(const sharded_queue&) = delete;
+
+    void push(const T& value) {
+        emplace(value);
+    }
+
+    void push(T&& value) {
+        emplace(std::move(value));
+    }
+
+    template <typename... Args>
+    void emplace(Args&&... args) {
+        lane &l = home_lane();
+        lock_guard lock(l.mtx, m_stats);
+        l.items.emplace_back(std::forward<Args>(args)...);
+        l.size.store(l.items.size(), std::memory_order_relaxed);
+        m_stats.add(stats::sharded_queue_counter::pushes);
+    }
+
+    // Pushes [first, last) under a single lane lock.
+    template <typename InputIt>
+    void push_bulk(InputIt first, InputIt last) {
+        lane &l = home_lane();
+        lock_guard lock(l.mtx, m_stats);
+        size_t before = l.items.size();
+        l.items.insert(l.items.end(), first, last);
+        l.size.store(l.items.size(), std::memory_order_relaxed);
+        m_stats.add(stats::sharded_queue_counter::pushes, l.items.size() - before);
+    }
+
+    bool try_pop(T& value) {
+        return pop_bulk(&value, 1) == 1;
+    }
+
+    // Moves up to `max` elements into `out`, all taken from the first
+    // non-empty lane found. Returns the number of elements written.
+    template <typename OutputIt>
+    size_t pop_bulk(OutputIt out, size_t max) {
+        if (max == 0) return 0;
+        size_t start = thread_slot() & (lane_count - 1);
+        for (size_t i = 0; i < lane_count; ++i) {
+            lane &l = lanes[(start + i) & (lane_count - 1)];
+            if (l.size.load(std::memory_order_relaxed) == 0) {
+                continue;
+            }
+            lock_guard lock(l.mtx, m_stats);
+            size_t n = std::min(max, l.items.size());
+            if (n == 0) {
+                continue;
+            }
+            auto first = l.items.begin();
+            std::move(first, first + n, out);
+            l.items.erase(first, first + n);
+            l.size.store(l.items.size(), std::memory_order_relaxed);
+            m_stats.add(stats::sharded_queue_counter::pops, n);
+            if (i != 0) {
+                m_stats.add(stats::sharded_queue_counter::steals, n);
+            }
+            return n;
+        }
+        return 0;
+    }
+
+    // approximate while producers and consumers are running
+    size_t size() const noexcept {
+        size_t total = 0;
+        for (size_t i = 0; i < lane_count; ++i) {
+            total += lanes[i].size.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    bool isEmpty() const noexcept {
+        return size() == 0;
+    }
+
+    size_t lanes_count() const noexcept {
+        return lane_count;
+    }
+
+    stats::sharded_queue_snapshot stats() const noexcept {
+        using c = stats::sharded_queue_counter;
+        stats::sharded_queue_snapshot res;
+        res.pushes = m_stats.sum(c::pushes);
+        res.pops = m_stats.sum(c::pops);
+        res.steals = m_stats.sum(c::steals);
+        res.lock_acquisitions = m_stats.sum(c::lock_acquisitions);
+        res.lock_wait_ns = m_stats.sum(c::lock_wait_ns);
+        res.lock_hold_ns = m_stats.sum(c::lock_hold_ns);
+        return res;
+    }
+};
+
+}  // namespace multithreaded_ds
@@ -0,0 +1,374 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "futex.hpp"
+#include "stats.hpp"
+
+namespace multithreaded_ds {
+
+// Bounded queue living in a POSIX shared memory object, for passing
+// messages between processes on one host without sockets. Messages are
+// written straight into the shared slots and read from them in place
+// (push_with / pop_with), so nothing goes through the kernel except the
+// occasional futex wake of a sleeping peer.
+//
+// Layout: a header followed by `capacity` slots. Nothing in the region is
+// a pointer, slots are found by offset from wherever the region happens to
+// be mapped, so every process may map it at a different address. Slots
+// carry a sequence number (Vyukov's bounded queue): a producer owns slot
+// pos when its sequence is pos, the consumer when it is pos + 1.
+//
+// One consumer process. Producers claim a position by CAS on the tail
+// word, whose top bit is the closed flag, so no claim succeeds once
+// close() has set it; MultiProducer adds the retry loop for contended
+// claims. T must be trivially copyable. A process that dies halfway through a push
+// leaves its slot unpublished and stalls the consumer there.
+//
+// Initialisation survives crashes: the first process to map the region
+// stamps its pid into the init word, formats the header and marks it
+// ready; if it dies before that, the next process to open the queue sees
+// a dead pid and formats the region again. Liveness is a kill(pid, 0)
+// probe, so if the dead initializer's pid has been reused by an unrelated
+// process by then, openers keep waiting for a format that never comes;
+// unlink the name and start over in that case.
+template <typename T, bool MultiProducer = false>
+class shm_queue {
+    static_assert(std::is_trivially_copyable_v<T>, "shm_queue elements are copied between processes");
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "shm_queue needs address-free 64-bit atomics");
+
+private:
+    static constexpr uint32_t magic = 0x4d545153;  // "MTQS"
+    static constexpr uint64_t state_ready = 2;
+    static constexpr uint64_t state_initializing = 1;
+    // set in the tail word by close()
+    static constexpr uint64_t closed_bit = uint64_t(1) << 63;
+
+    struct header {
+        // (initializer pid << 2) | state, zero in a fresh region
+        std::atomic<uint64_t> init;
+        uint32_t magic;
+        uint32_t slot_size;
+        uint64_t capacity;
+
+        alignas(stats::cache_line_size) std::atomic<uint64_t> tail;
+        // futex word bumped when the consumer must re-check, and its sleeper count
+        std::atomic<uint32_t> not_empty;
+        std::atomic<uint32_t> consumer_sleepers;
+
+        alignas(stats::cache_line_size) std::atomic<uint64_t> head;
+        std::atomic<uint32_t> not_full;
+        std::atomic<uint32_t> producer_sleepers;
+    };
+
+    struct slot {
+        std::atomic<uint64_t> seq;
+        T value;
+    };
+
+public:
+    // Opens the queue `name` (as for shm_open, e.g. "/orders"), creating
+    // and formatting it if needed. capacity is rounded up to a power of
+    // two and must match what the creator used. Returns nullptr with errno
+    // set on failure.
+    static std::unique_ptr<shm_queue> open(const char *name, size_t capacity) {
+        size_t cap = 1;
+        while (cap < capacity) cap <<= 1;
+        size_t bytes = sizeof(header) + cap * sizeof(slot);
+
+        int fd = ::shm_open(name, O_RDWR | O_CREAT, 0600);
+        if (fd < 0) {
+            return nullptr;
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            return fail(fd);
+        }
+        // a fresh object is empty; growing it zero-fills the header
+        if (st.st_size == 0 && ::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+            return fail(fd);
+        }
+        if (st.st_size != 0 && static_cast<size_t>(st.st_size) != bytes) {
+            errno = EINVAL;
+            return fail(fd);
+        }
+        void *mem = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (mem == MAP_FAILED) {
+            return fail(fd);
+        }
+        std::unique_ptr<shm_queue> res(new shm_queue(fd, mem, bytes));
+        if (!res->attach(cap)) {
+            errno = EINVAL;
+            return nullptr;
+        }
+        return res;
+    }
+
+    // removes the name; processes that have it open keep their mapping
+    static bool unlink(const char *name) noexcept {
+        return ::shm_unlink(name) == 0;
+    }
+
+    ~shm_queue() {
+        ::munmap(m_base, m_bytes);
+        ::close(m_fd);
+    }
+
+    shm_queue(const shm_queue&) = delete;
+    shm_queue& operator=(const shm_queue&) = delete;
+
+    // Producer side. fill(T&) writes the message directly into its slot.
+    // Returns false if the queue is full or closed.
+    template <typename F>
+    bool push_with(F &&fill) noexcept {
+        uint64_t pos = m_header->tail.load(std::memory_order_relaxed);
+        slot *s;
+        while (true) {
+            if (pos & closed_bit) {
+                return false;
+            }
+            s = slot_at(pos);
+            uint64_t seq = s->seq.load(std::memory_order_acquire);
+            if (seq < pos) {
+                return false;
+            }
+            if constexpr (MultiProducer) {
+                if (seq == pos && m_header->tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+                if (seq > pos) {
+                    pos = m_header->tail.load(std::memory_order_relaxed);
+                }
+            } else if (m_header->tail.compare_exchange_strong(pos, pos + 1, std::memory_order_relaxed)) {
+                // only close() can change the tail under a single producer
+                break;
+            }
+        }
+        fill(s->value);
+        s->seq.store(pos + 1, std::memory_order_release);
+        wake(m_header->not_empty, m_header->consumer_sleepers, 1);
+        return true;
+    }
+
+    bool push(const T &value) noexcept {
+        return push_with([&value](T &s) { s = value; });
+    }
+
+    // push that waits for room; false once the queue is closed
+    bool wait_push(const T &value) noexcept {
+        while (true) {
+            if (push(value)) {
+                return true;
+            }
+            if (isClosed()) {
+                return false;
+            }
+            sleep_on(m_header->not_full, m_header->producer_sleepers, nullptr,
+                     [this]() { return !full() || isClosed(); });
+        }
+    }
+
+    // Consumer side. read(const T&) sees the message in place; the slot is
+    // handed back to producers when it returns. False if empty.
+    template <typename F>
+    bool pop_with(F &&read) noexcept {
+        uint64_t pos = m_header->head.load(std::memory_order_relaxed);
+        slot *s = slot_at(pos);
+        if (s->seq.load(std::memory_order_acquire) != pos + 1) {
+            return false;
+        }
+        read(static_cast<const T&>(s->value));
+        s->seq.store(pos + m_capacity, std::memory_order_release);
+        m_header->head.store(pos + 1, std::memory_order_relaxed);
+        // one slot freed, one producer can use it
+        wake(m_header->not_full, m_header->producer_sleepers, 1);
+        return true;
+    }
+
+    bool pop(T &value) noexcept {
+        return pop_with([&value](const T &s) { value = s; });
+    }
+
+    // Blocks until a message arrives; false once the queue is closed and drained.
+    bool wait_pop(T &value) noexcept {
+        return wait_pop_until(value, nullptr);
+    }
+
+    template <typename Rep, typename Period>
+    bool wait_pop_for(T &value, const std::chrono::duration<Rep, Period> &timeout) noexcept {
+        auto deadline = stats::clock::now() + std::chrono::duration_cast<stats::clock::duration>(timeout);
+        return wait_pop_until(value, &deadline);
+    }
+
+    // Rejects further pushes and wakes every waiter, in every process.
+    // Pushes that claimed their slot before still complete and are popped.
+    void close() noexcept {
+        m_header->tail.fetch_or(closed_bit, std::memory_order_seq_cst);
+        m_header->not_empty.fetch_add(1, std::memory_order_release);
+        futex_wake_all(m_header->not_empty, true);
+        m_header->not_full.fetch_add(1, std::memory_order_release);
+        futex_wake_all(m_header->not_full, true);
+    }
+
+    bool isClosed() const noexcept {
+        return (m_header->tail.load(std::memory_order_acquire) & closed_bit) != 0;
+    }
+
+    // approximate while producers and the consumer are running
+    size_t size() const noexcept {
+        uint64_t head = m_header->head.load(std::memory_order_acquire);
+        uint64_t tail = m_header->tail.load(std::memory_order_acquire) & ~closed_bit;
+        return tail > head ? static_cast<size_t>(tail - head) : 0;
+    }
+
+    bool isEmpty() const noexcept { return size() == 0; }
+
+    size_t capacity() const noexcept { return m_capacity; }
+
+private:
+    shm_queue(int fd, void *base, size_t bytes) noexcept :
+    m_fd(fd),
+    m_base(base),
+    m_bytes(bytes),
+    m_header(static_cast<header*>(base)),
+    m_capacity(0) {
+
+    }
+
+    static std::unique_ptr<shm_queue> fail(int fd) noexcept {
+        int err = errno;
+        ::close(fd);
+        errno = err;
+        return nullptr;
+    }
+
+    // Formats the region if nobody has (or the process that started to
+    // died), otherwise waits for it to be ready. False on a layout mismatch.
+    // A reused pid looks alive to alive(), see the class comment.
+    bool attach(size_t cap) noexcept {
+        uint64_t self = (static_cast<uint64_t>(::getpid()) << 2) | state_initializing;
+        uint64_t init = m_header->init.load(std::memory_order_acquire);
+        while ((init & 3) != state_ready) {
+            bool claimable = init == 0 || ((init & 3) == state_initializing && !alive(static_cast<pid_t>(init >> 2)));
+            if (claimable && m_header->init.compare_exchange_strong(init, self, std::memory_order_acq_rel)) {
+                format(cap);
+                m_header->init.store((self & ~uint64_t(3)) | state_ready, std::memory_order_release);
+                break;
+            }
+            if (!claimable) {
+                ::usleep(100);
+                init = m_header->init.load(std::memory_order_acquire);
+            }
+        }
+        if (m_header->magic != magic || m_header->slot_size != sizeof(slot) || m_header->capacity != cap) {
+            return false;
+        }
+        m_capacity = cap;
+        return true;
+    }
+
+    void format(size_t cap) noexcept {
+        m_header->magic = magic;
+        m_header->slot_size = sizeof(slot);
+        m_header->capacity = cap;
+        m_header->tail.store(0, std::memory_order_relaxed);
+        m_header->head.store(0, std::memory_order_relaxed);
+        m_header->not_empty.store(0, std::memory_order_relaxed);
+        m_header->not_full.store(0, std::memory_order_relaxed);
+        m_header->consumer_sleepers.store(0, std::memory_order_relaxed);
+        m_header->producer_sleepers.store(0, std::memory_order_relaxed);
+        slot *slots = reinterpret_cast<slot*>(reinterpret_cast<char*>(m_base) + sizeof(header));
+        for (size_t i = 0; i < cap; ++i) {
+            slots[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    static bool alive(pid_t pid) noexcept {
+        return pid > 0 && (::kill(pid, 0) == 0 || errno != ESRCH);
+    }
+
+    slot* slot_at(uint64_t pos) const noexcept {
+        char *slots = reinterpret_cast<char*>(m_base) + sizeof(header);
+        return reinterpret_cast<slot*>(slots) + (pos & (m_capacity - 1));
+    }
+
+    bool full() const noexcept {
+        uint64_t pos = m_header->tail.load(std::memory_order_relaxed) & ~closed_bit;
+        return slot_at(pos)->seq.load(std::memory_order_acquire) < pos;
+    }
+
+    bool has_item() const noexcept {
+        uint64_t pos = m_header->head.load(std::memory_order_relaxed);
+        return slot_at(pos)->seq.load(std::memory_order_acquire) == pos + 1;
+    }
+
+    // closed and every push that got in before close() has been popped
+    bool drained() const noexcept {
+        uint64_t tail = m_header->tail.load(std::memory_order_acquire);
+        return (tail & closed_bit) && m_header->head.load(std::memory_order_relaxed) == (tail & ~closed_bit);
+    }
+
+    // pairs with the seq_cst increment in sleep_on(): either the sleeper
+    // sees our update or we see it registered and wake it
+    static void wake(std::atomic<uint32_t> &word, std::atomic<uint32_t> &sleepers, int count) noexcept {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers.load(std::memory_order_seq_cst) != 0) {
+            word.fetch_add(1, std::memory_order_release);
+            futex_wake(word, count, true);
+        }
+    }
+
+    template <typename Ready>
+    static void sleep_on(std::atomic<uint32_t> &word, std::atomic<uint32_t> &sleepers,
+                         const stats::clock::time_point *deadline, Ready ready) noexcept {
+        uint32_t seq = word.load(std::memory_order_acquire);
+        sleepers.fetch_add(1, std::memory_order_seq_cst);
+        if (!ready()) {
+            if (deadline) {
+                auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(*deadline - stats::clock::now());
+                futex_wait(word, seq, &ns, true);
+            } else {
+                futex_wait(word, seq, nullptr, true);
+            }
+        }
+        sleepers.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    bool wait_pop_until(T &value, const stats::clock::time_point *deadline) noexcept {
+        while (true) {
+            if (pop(value)) return true;
+            // a push that claimed its slot before close() may still be
+            // writing it, wait for it to publish
+            if (drained()) return false;
+            if (deadline && stats::clock::now() >= *deadline) return pop(value);
+            sleep_on(m_header->not_empty, m_header->consumer_sleepers, deadline,
+                     [this]() { return has_item() || drained(); });
+        }
+    }
+
+    int m_fd;
+    void *m_base;
+    size_t m_bytes;
+    header *m_header;
+    size_t m_capacity;
+};
+
+template <typename T>
+using shm_spsc_queue = shm_queue<T, false>;
+
+template <typename T>
+using shm_mpsc_queue = shm_queue<T, true>;
+
+} // namespace multithreaded_ds
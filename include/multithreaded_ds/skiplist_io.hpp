@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "concurrent_skiplist.hpp"
+
+namespace multithreaded_ds {
+
+// Persistence for Skiplist, kept out of concurrent_skiplist.hpp so the
+// container itself needs nothing beyond the standard library.
+//
+// On-disk layout: this header followed by `count` keys in ascending order,
+// each stored as its raw sizeof(T) bytes in host byte order.
+struct skiplist_file_header {
+    char magic[8];
+    uint32_t format_version;
+    uint32_t key_size;
+    uint64_t count;
+};
+
+inline constexpr char skiplist_file_magic[8] = {'M', 'T', 'D', 'S', 'S', 'K', 'L', '\0'};
+inline constexpr uint32_t skiplist_file_format_version = 1;
+
+// Streams the list to `path` from a snapshot, so writers are not blocked
+// and memory use stays flat. The file is written next to the target,
+// flushed to disk and only then renamed over it, so after a crash `path`
+// holds either the old or the new contents in full. Returns false on I/O
+// error.
+template <typename T, int P>
+bool save_to(Skiplist<T, P> &list, const std::string &path) {
+    static_assert(std::is_trivially_copyable<T>::value, "save_to needs trivially copyable keys");
+    std::string tmp_path = path + ".tmp";
+    std::FILE *file = std::fopen(tmp_path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    std::vector<char> buffer(1 << 20);
+    std::setvbuf(file, buffer.data(), _IOFBF, buffer.size());
+
+    skiplist_file_header header{};
+    std::memcpy(header.magic, skiplist_file_magic, sizeof(skiplist_file_magic));
+    header.format_version = skiplist_file_format_version;
+    header.key_size = sizeof(T);
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1;
+
+    {
+        auto snap = list.snapshot();
+        typename Skiplist<T, P>::snapshot_handle::iterator it(snap);
+        for (it.seek_to_first(); ok && it.valid(); it.next()) {
+            ok = std::fwrite(&it.value(), sizeof(T), 1, file) == 1;
+            ++header.count;
+        }
+    }
+
+    ok = ok && std::fseek(file, 0, SEEK_SET) == 0 && std::fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = ok && std::fflush(file) == 0 && ::fsync(::fileno(file)) == 0;
+    ok = (std::fclose(file) == 0) && ok;
+    if (ok) {
+        ok = std::rename(tmp_path.c_str(), path.c_str()) == 0;
+    }
+    if (!ok) {
+        std::remove(tmp_path.c_str());
+    }
+    return ok;
+}
+
+// Maps a file written by save_to and builds the list in one pass with
+// Skiplist::append_sorted. The list must be empty. Returns false if it is
+// not, or the file is missing, of another format version or key size,
+// not exactly the size its header implies, or has keys out of order.
+template <typename T, int P>
+bool load_from(Skiplist<T, P> &list, const std::string &path) {
+    static_assert(std::is_trivially_copyable<T>::value, "load_from needs trivially copyable keys");
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(skiplist_file_header)) {
+        ::close(fd);
+        return false;
+    }
+    size_t file_size = static_cast<size_t>(st.st_size);
+#ifdef MAP_POPULATE
+    // read the whole file in up front instead of faulting page by page
+    int flags = MAP_PRIVATE | MAP_POPULATE;
+#else
+    int flags = MAP_PRIVATE;
+#endif
+    void *map = ::mmap(nullptr, file_size, PROT_READ, flags, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+    ::madvise(map, file_size, MADV_SEQUENTIAL);
+
+    const char *data = static_cast<const char*>(map);
+    skiplist_file_header header;
+    std::memcpy(&header, data, sizeof(header));
+    size_t payload = file_size - sizeof(header);
+    bool ok = std::memcmp(header.magic, skiplist_file_magic, sizeof(skiplist_file_magic)) == 0 &&
+              header.format_version == skiplist_file_format_version &&
+              header.key_size == sizeof(T) &&
+              payload % sizeof(T) == 0 && header.count == payload / sizeof(T);
+
+    if (ok) {
+        const char *p = data + sizeof(header);
+        ok = list.append_sorted(header.count, [&p]() {
+            T value;
+            std::memcpy(&value, p, sizeof(T));
+            p += sizeof(T);
+            return value;
+        });
+    }
+    ::munmap(map, file_size);
+    return ok;
+}
+
+} // namespace multithreaded_ds
@@ -9,11 +9,23 @@
 #include <atomic>
 #include <algorithm>
 
+#include "stats.hpp"
+
 namespace multithreaded_ds {
-class slab {
+// The header is padded to a cache line so blocks that follow it keep any
+// power-of-two alignment up to 64 bytes.
+class alignas(64) slab {
 public:
     static constexpr size_t page_size = 4096;
 
+    // Slab a block was carved from. Blocks start anywhere in
+    // [this + sizeof(slab), this + sizeof(slab) + page_size), so the header
+    // is subtracted before rounding down to the page boundary.
+    static slab* owner(void *p) noexcept {
+        uintptr_t addr = reinterpret_cast<uintptr_t>(p) - sizeof(slab);
+        return reinterpret_cast<slab*>(addr & ~(page_size - 1));
+    }
+
     static slab* create(size_t block_size) {
         size_t total = sizeof(slab) + page_size;
         void* mem = ::operator new(total, std::align_val_t{page_size});
@@ -68,6 +80,7 @@ public:
     size_t size() const noexcept { return m_valid_page; }
     bool empty() const noexcept { return m_valid_page == 0; }
     bool full() const noexcept { return m_valid_page == page_size / m_block_size; }
+    size_t block_size() const noexcept { return m_block_size; }
 
 private:
     char* m_data_set;
@@ -86,17 +99,21 @@ public:
         for (auto i : local_threads) {
             i->destroy();
         }
+        m_stats.sub(stats::slab_counter::slabs_local, local_threads.size());
+        m_stats.add(stats::slab_counter::slabs_destroyed, local_threads.size());
         std::lock_guard<std::mutex> lock(global_mtx);
         for (auto i : global_threads) {
             i->destroy();
         }
+        m_stats.sub(stats::slab_counter::slabs_global, global_threads.size());
+        m_stats.add(stats::slab_counter::slabs_destroyed, global_threads.size());
     }
     void* allocate() {
         if (!local_threads.empty()) {
             slab *S = local_threads.back();
             void *res = S->allocate();
             if (S->empty()) {
-                local_threads.pop_back();
+                pop_local();
             }
             return res;
         }
@@ -105,10 +122,12 @@ public:
             if (!global_threads.empty()) {
                 push_local(global_threads.back());
                 global_threads.pop_back();
+                m_stats.sub(stats::slab_counter::slabs_global);
             }
         }
         if (local_threads.empty()) {
             push_local(slab::create(m_block_size));
+            m_stats.add(stats::slab_counter::slabs_created);
         }
         auto S = pop_local();
         auto p = S->allocate();
@@ -118,37 +137,48 @@ public:
         return p;
     }
     void deallocate(void *p) {
-        uintptr_t addr = reinterpret_cast<uintptr_t>(p);
-        uintptr_t base = addr & ~(slab::page_size - 1);
-        slab* S = reinterpret_cast<slab*>(base);
+        slab* S = slab::owner(p);
         S->deallocate(p);
         if (S->full()) {
             auto it = std::find(local_threads.begin(), local_threads.end(), S);
             if (it != local_threads.end()) {
                 local_threads.erase(it);
+                m_stats.sub(stats::slab_counter::slabs_local);
             }
             std::lock_guard<std::mutex> lock(global_mtx);
             global_threads.push_back(S);
+            m_stats.add(stats::slab_counter::slabs_global);
         }
      }
+
+    static stats::slab_snapshot stats() noexcept {
+        using c = stats::slab_counter;
+        stats::slab_snapshot res;
+        res.slabs_created = m_stats.sum(c::slabs_created);
+        res.slabs_destroyed = m_stats.sum(c::slabs_destroyed);
+        res.slabs_local = m_stats.sum(c::slabs_local);
+        res.slabs_global = m_stats.sum(c::slabs_global);
+        res.slabs_exhausted = res.slabs_created - res.slabs_destroyed - res.slabs_local - res.slabs_global;
+        return res;
+    }
 private:
     slab* pop_local() {
         auto p = local_threads.back();
         local_threads.pop_back();
+        m_stats.sub(stats::slab_counter::slabs_local);
         return p;
     }
     void push_local(slab* p) {
         local_threads.push_back(p);    
+        m_stats.add(stats::slab_counter::slabs_local);
     }
 
     size_t m_block_size;
-    thread_local static std::vector<slab*> local_threads;
-    static std::vector<slab*> global_threads;
-    static std::mutex global_mtx;
+    inline thread_local static std::vector<slab*> local_threads;
+    inline static std::vector<slab*> global_threads;
+    inline static std::mutex global_mtx;
+    // slab lists are shared by every allocator, so are their counters
+    inline static stats::counters<stats::slab_counter> m_stats;
 };
 
-thread_local std::vector<slab*> slab_allocator::local_threads;
-std::vector<slab*> slab_allocator::global_threads;
-std::mutex slab_allocator::global_mtx;
-
 } // namespace multithreaded_ds 
\ No newline at end of file
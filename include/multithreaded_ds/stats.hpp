@@ -0,0 +1,262 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Instrumentation is opt-in. Build with -DMULTITHREADED_DS_ENABLE_STATS=1 to
+// turn the counters on; otherwise every hook below is an empty inline call.
+//
+// The setting changes the layout of every container that keeps counters,
+// while their type names stay the same. It must therefore be identical in
+// every translation unit of a program: mixing them is an ODR violation
+// that the linker does not catch. Set it once for the whole build (e.g.
+// as a project-wide compile definition), never per file.
+#ifndef MULTITHREADED_DS_ENABLE_STATS
+#define MULTITHREADED_DS_ENABLE_STATS 0
+#endif
+
+namespace multithreaded_ds {
+namespace stats {
+
+constexpr bool enabled = MULTITHREADED_DS_ENABLE_STATS != 0;
+constexpr size_t cache_line_size = 64;
+constexpr size_t shard_count = 16;
+
+using clock = std::chrono::steady_clock;
+
+// shard owned by the calling thread, assigned round robin on first use
+inline size_t this_shard() noexcept {
+    static std::atomic<size_t> next_shard{0};
+    thread_local size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % shard_count;
+    return shard;
+}
+
+inline uint64_t elapsed_ns(clock::time_point from, clock::time_point to) noexcept {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count());
+}
+
+enum class queue_counter : size_t {
+    pushes,
+    pops,
+    lock_acquisitions,
+    lock_wait_ns,
+    lock_hold_ns,
+    max_depth,
+    count_
+};
+
+enum class sharded_queue_counter : size_t {
+    pushes,
+    pops,
+    steals,
+    lock_acquisitions,
+    lock_wait_ns,
+    lock_hold_ns,
+    count_
+};
+
+enum class pool_counter : size_t {
+    tasks_submitted,
+    tasks_completed,
+    task_wait_ns,
+    task_run_ns,
+    lock_acquisitions,
+    lock_wait_ns,
+    lock_hold_ns,
+    max_queue_depth,
+    timers_scheduled,
+    timers_fired,
+    timers_cancelled,
+    timers_failed,
+    tasks_cancelled,
+    tasks_discarded,
+    count_
+};
+
+enum class slab_counter : size_t {
+    slabs_created,
+    slabs_destroyed,
+    slabs_local,
+    slabs_global,
+    count_
+};
+
+enum class object_pool_counter : size_t {
+    allocations,
+    deallocations,
+    depot_exchanges,
+    slab_allocations,
+    slab_frees,
+    count_
+};
+
+struct queue_snapshot {
+    uint64_t pushes = 0;
+    uint64_t pops = 0;
+    uint64_t lock_acquisitions = 0;
+    uint64_t lock_wait_ns = 0;
+    uint64_t lock_hold_ns = 0;
+    uint64_t max_depth = 0;
+};
+
+struct sharded_queue_snapshot {
+    uint64_t pushes = 0;
+    uint64_t pops = 0;
+    // pops served from a lane other than the consumer's home lane
+    uint64_t steals = 0;
+    uint64_t lock_acquisitions = 0;
+    uint64_t lock_wait_ns = 0;
+    uint64_t lock_hold_ns = 0;
+};
+
+struct pool_snapshot {
+    uint64_t tasks_submitted = 0;
+    uint64_t tasks_completed = 0;
+    uint64_t task_wait_ns = 0;
+    uint64_t task_run_ns = 0;
+    uint64_t lock_acquisitions = 0;
+    uint64_t lock_wait_ns = 0;
+    uint64_t lock_hold_ns = 0;
+    uint64_t max_queue_depth = 0;
+    uint64_t timers_scheduled = 0;
+    // timer runs handed to the workers, periodic timers count once per run
+    uint64_t timers_fired = 0;
+    uint64_t timers_cancelled = 0;
+    // timer runs that ended in an exception
+    uint64_t timers_failed = 0;
+    // task_group tasks skipped because their group was cancelled
+    uint64_t tasks_cancelled = 0;
+    // queued tasks dropped by shutdown_now()
+    uint64_t tasks_discarded = 0;
+};
+
+struct object_pool_snapshot {
+    uint64_t allocations = 0;
+    uint64_t deallocations = 0;
+    // magazine swaps with the depot, each one takes the depot lock
+    uint64_t depot_exchanges = 0;
+    // allocations that missed every magazine and went to the slab layer
+    uint64_t slab_allocations = 0;
+    // blocks trim() handed back to their slabs
+    uint64_t slab_frees = 0;
+};
+
+// slabs are either cached on some thread (local, partially used), parked in
+// the global list (completely free) or exhausted and owned by no list
+struct slab_snapshot {
+    uint64_t slabs_created = 0;
+    uint64_t slabs_destroyed = 0;
+    uint64_t slabs_local = 0;
+    uint64_t slabs_global = 0;
+    uint64_t slabs_exhausted = 0;
+};
+
+// Counter is an enum whose last enumerator is `count_`. Every thread writes
+// only to its own cache-line aligned shard, so the hot path never bounces a
+// shared line; readers fold the shards together when taking a snapshot.
+// The default for Enabled must agree program-wide, see the top of the file.
+template <typename Counter, bool Enabled = enabled>
+class counters {
+private:
+    static constexpr size_t N = static_cast<size_t>(Counter::count_);
+
+    struct alignas(cache_line_size) shard {
+        std::array<std::atomic<uint64_t>, N> values{};
+    };
+
+    std::array<shard, shard_count> shards;
+
+    std::atomic<uint64_t>& slot(Counter c) noexcept {
+        return shards[this_shard()].values[static_cast<size_t>(c)];
+    }
+
+public:
+    void add(Counter c, uint64_t delta = 1) noexcept {
+        slot(c).fetch_add(delta, std::memory_order_relaxed);
+    }
+
+    // gauges are kept as sums of signed deltas; wraparound cancels out in sum()
+    void sub(Counter c, uint64_t delta = 1) noexcept {
+        slot(c).fetch_sub(delta, std::memory_order_relaxed);
+    }
+
+    void update_max(Counter c, uint64_t value) noexcept {
+        auto &s = slot(c);
+        uint64_t cur = s.load(std::memory_order_relaxed);
+        while (cur < value && !s.compare_exchange_weak(cur, value, std::memory_order_relaxed)) {}
+    }
+
+    uint64_t sum(Counter c) const noexcept {
+        uint64_t total = 0;
+        for (auto &s : shards) {
+            total += s.values[static_cast<size_t>(c)].load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    uint64_t max(Counter c) const noexcept {
+        uint64_t res = 0;
+        for (auto &s : shards) {
+            uint64_t v = s.values[static_cast<size_t>(c)].load(std::memory_order_relaxed);
+            if (v > res) res = v;
+        }
+        return res;
+    }
+};
+
+template <typename Counter>
+class counters<Counter, false> {
+public:
+    void add(Counter, uint64_t = 1) noexcept {}
+    void sub(Counter, uint64_t = 1) noexcept {}
+    void update_max(Counter, uint64_t) noexcept {}
+    uint64_t sum(Counter) const noexcept { return 0; }
+    uint64_t max(Counter) const noexcept { return 0; }
+};
+
+// Point in time captured only when stats are enabled.
+template <bool Enabled = enabled>
+struct stamp {
+    clock::time_point at;
+    stamp() noexcept : at(clock::now()) {}
+    uint64_t elapsed_ns() const noexcept { return stats::elapsed_ns(at, clock::now()); }
+};
+
+template <>
+struct stamp<false> {
+    uint64_t elapsed_ns() const noexcept { return 0; }
+};
+
+// Lock guard that records wait and hold times into Counter::lock_wait_ns,
+// Counter::lock_hold_ns and Counter::lock_acquisitions.
+template <typename Mutex, typename Counter>
+class timed_lock_guard {
+public:
+    timed_lock_guard(Mutex &m, counters<Counter> &c) noexcept : mtx(m), m_counters(c) {
+        stamp<> before;
+        mtx.lock();
+        acquired = stamp<>();
+        m_counters.add(Counter::lock_acquisitions);
+        m_counters.add(Counter::lock_wait_ns, before.elapsed_ns());
+    }
+
+    ~timed_lock_guard() noexcept {
+        uint64_t held = acquired.elapsed_ns();
+        mtx.unlock();
+        m_counters.add(Counter::lock_hold_ns, held);
+    }
+
+    timed_lock_guard(const timed_lock_guard&) = delete;
+    timed_lock_guard& operator=(const timed_lock_guard&) = delete;
+
+private:
+    Mutex &mtx;
+    counters<Counter> &m_counters;
+    stamp<> acquired;
+};
+
+}  // namespace stats
+}  // namespace multithreaded_ds
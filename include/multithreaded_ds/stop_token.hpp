@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <utility>
+
+namespace multithreaded_ds {
+
+// Minimal C++17 stand-in for std::stop_source/std::stop_token. A source
+// may be linked to a parent token, in which case its tokens also report
+// a stop once the parent is stopped (a task group inside a pool that is
+// shutting down). Tokens are polled, there are no stop callbacks.
+class stop_token;
+
+namespace detail {
+struct stop_state {
+    std::atomic<bool> stopped{false};
+    std::shared_ptr<stop_state> parent;
+
+    bool stop_requested() const noexcept {
+        for (const stop_state *s = this; s != nullptr; s = s->parent.get()) {
+            if (s->stopped.load(std::memory_order_acquire)) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+} // namespace detail
+
+class stop_token {
+public:
+    // a default token can never be stopped
+    stop_token() = default;
+
+    bool stop_requested() const noexcept {
+        return m_state != nullptr && m_state->stop_requested();
+    }
+
+    bool stop_possible() const noexcept { return m_state != nullptr; }
+
+private:
+    friend class stop_source;
+    explicit stop_token(std::shared_ptr<detail::stop_state> state) : m_state(std::move(state)) {}
+
+    std::shared_ptr<detail::stop_state> m_state;
+};
+
+class stop_source {
+public:
+    stop_source() : m_state(std::make_shared<detail::stop_state>()) {}
+
+    explicit stop_source(const stop_token &parent) : stop_source() {
+        m_state->parent = parent.m_state;
+    }
+
+    // true only for the call that made the transition
+    bool request_stop() noexcept {
+        return !m_state->stopped.exchange(true, std::memory_order_acq_rel);
+    }
+
+    bool stop_requested() const noexcept { return m_state->stop_requested(); }
+
+    stop_token get_token() const { return stop_token(m_state); }
+
+private:
+    std::shared_ptr<detail::stop_state> m_state;
+};
+
+} // namespace multithreaded_ds
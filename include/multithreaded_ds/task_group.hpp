@@ -0,0 +1,136 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+#include "stop_token.hpp"
+#include "threads_pool.hpp"
+
+namespace multithreaded_ds {
+
+// Structured group of tasks on a thread_pool, e.g. the subtasks of one
+// request.
+//
+//   run(f)     queues f; f may take a stop_token as its only argument to
+//              poll for cancellation while it runs
+//   cancel()   stops the group: tasks that have not started are skipped
+//              when a worker dequeues them, running ones see their token
+//              stopped
+//   wait()     blocks until every task has finished or been skipped and
+//              rethrows the first exception a task threw
+//
+// The first exception also cancels the rest of the group. The group's
+// token is linked to the pool's, so shutdown_now() cancels it too, and
+// tasks the pool discards still count as finished. wait() must not be
+// called from a task of the same pool, it does not run queued work.
+class task_group {
+public:
+    explicit task_group(thread_pool &pool) :
+    m_pool(pool),
+    m_state(std::make_shared<state>(pool.get_stop_token())) {
+
+    }
+
+    // a group is never abandoned with tasks in flight
+    ~task_group() {
+        std::unique_lock<std::mutex> lock(m_state->mtx);
+        m_state->cv.wait(lock, [this] { return m_state->pending == 0; });
+    }
+
+    task_group(const task_group&) = delete;
+    task_group& operator=(const task_group&) = delete;
+
+    template <typename F>
+    void run(F &&f) {
+        auto j = std::make_shared<job<std::decay_t<F>>>(m_state, &m_pool, std::forward<F>(f));
+        m_pool.enqueue([j]() { j->run(); });
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(m_state->mtx);
+        m_state->cv.wait(lock, [this] { return m_state->pending == 0; });
+        if (m_state->error) {
+            std::exception_ptr e = std::move(m_state->error);
+            m_state->error = nullptr;
+            std::rethrow_exception(e);
+        }
+    }
+
+    void cancel() noexcept { m_state->source.request_stop(); }
+
+    bool is_cancelled() const noexcept { return m_state->source.stop_requested(); }
+
+    stop_token get_stop_token() const { return m_state->source.get_token(); }
+
+private:
+    // outlives the group object for as long as a job refers to it
+    struct state {
+        explicit state(const stop_token &parent) : source(parent) {}
+
+        std::mutex mtx;
+        std::condition_variable cv;
+        size_t pending = 0;
+        std::exception_ptr error;
+        stop_source source;
+    };
+
+    // Registers with the group when built and completes in its destructor,
+    // so a job that is skipped, runs, throws or is discarded by the pool is
+    // accounted for exactly once.
+    template <typename F>
+    class job {
+    public:
+        template <typename G>
+        job(std::shared_ptr<state> s, thread_pool *pool, G &&f) :
+        m_state(std::move(s)), m_pool(pool), m_func(std::forward<G>(f)) {
+            std::lock_guard<std::mutex> lock(m_state->mtx);
+            ++m_state->pending;
+        }
+
+        ~job() {
+            std::lock_guard<std::mutex> lock(m_state->mtx);
+            if (--m_state->pending == 0) {
+                m_state->cv.notify_all();
+            }
+        }
+
+        void run() {
+            stop_token token = m_state->source.get_token();
+            if (token.stop_requested()) {
+                m_pool->m_stats.add(stats::pool_counter::tasks_cancelled);
+                return;
+            }
+            try {
+                if constexpr (std::is_invocable_v<F&, stop_token>) {
+                    m_func(token);
+                } else {
+                    m_func();
+                }
+            } catch (...) {
+                {
+                    std::lock_guard<std::mutex> lock(m_state->mtx);
+                    if (!m_state->error) {
+                        m_state->error = std::current_exception();
+                    }
+                }
+                m_state->source.request_stop();
+            }
+        }
+
+    private:
+        std::shared_ptr<state> m_state;
+        thread_pool *m_pool;
+        F m_func;
+    };
+
+    thread_pool &m_pool;
+    std::shared_ptr<state> m_state;
+};
+
+} // namespace multithreaded_ds
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <future>
 #include <thread>
 #include <vector>
@@ -8,29 +9,68 @@
 #include <mutex>
 #include <condition_variable>
 
+#include "stats.hpp"
+#include "stop_token.hpp"
+#include "timing_wheel.hpp"
+
 namespace multithreaded_ds {
+class task_group;
+
 class thread_pool {
 public:
-    thread_pool(size_t threads = 8) : thread_count(threads), stop(false) {
+    using clock = std::chrono::steady_clock;
+    using timer_handle = timing_wheel::timer_id;
+
+    // resolution of schedule_*; timers never fire early, at most one tick late
+    static constexpr clock::duration timer_tick = std::chrono::milliseconds(1);
+
+    thread_pool(size_t threads = 8) : thread_count(threads), stop(false), timer_epoch(clock::now()) {
         workers.reserve(threads);
         for (size_t i = 0; i < threads; i++) {
-            workers.push_back(std::thread(thread_pool::worker_thread, this));
+            workers.push_back(std::thread(&thread_pool::worker_thread, this));
         }
     }
 
+    // Runs the whole backlog before returning, see shutdown_now() to drop it.
     ~thread_pool() {
+        // pending timers are dropped, tasks they already queued still run
+        stop_timers();
         {
             std::unique_lock<std::mutex> lock(queue_mtx);
             stop.store(true, std::memory_order_release);
         }
         cv.notify_all();
-        for (auto &i : workers) {
-            if (i.joinable()) {
-                i.join();
-            }
+        join_workers();
+    }
+
+    // Load shedding: requests stop on the pool's token (and so on every
+    // task_group of this pool), drops pending timers and discards every
+    // queued task without running it, then waits for the tasks already
+    // running. Futures of discarded tasks report broken_promise. Anything
+    // submitted afterwards is discarded as well. Returns the number of
+    // tasks discarded. May be called from a task of this pool: that task is
+    // not waited for, its worker exits once it returns.
+    size_t shutdown_now() {
+        m_stop_source.request_stop();
+        stop_timers();
+        std::queue<queued_task> discarded;
+        {
+            std::lock_guard<std::mutex> lock(queue_mtx);
+            stop.store(true, std::memory_order_release);
+            std::swap(discarded, task_queue);
         }
+        cv.notify_all();
+        size_t res = discarded.size();
+        m_stats.add(stats::pool_counter::tasks_discarded, res);
+        // destroyed outside the lock, discarded task_group jobs report back
+        discarded = std::queue<queued_task>();
+        join_workers();
+        return res;
     }
 
+    // stopped by shutdown_now(); tasks may poll it to bail out early
+    stop_token get_stop_token() const { return m_stop_source.get_token(); }
+
     template <typename F, typename... Args>
     auto submit(F &&f, Args&&... args) -> std::future<std::invoke_result_t<F, Args...>> {
         using return_type = std::invoke_result_t<F, Args...>;
@@ -38,38 +78,247 @@ public:
         std::shared_ptr<std::promise<return_type>> promise = std::make_shared<std::promise<return_type>>();
         std::future<return_type> future = promise->get_future();
 
-        {
-            std::unique_lock<std::mutex> lock(queue_mtx);
-
-            task_queue.push(
-                [ promise, func = std::forward<F>(f),
-                  tup = std::make_tuple(std::forward<Args>(args)...) ]() mutable
-                {
-                    try {
-                        if constexpr(std::is_void_v<return_type>) {
-                            std::apply(func, tup);
-                            promise->set_value();
-                        } else {
-                            auto result = std::apply(func, tup);
-                            promise->set_value(std::move(result));
-                        }
-                    } catch(...) {
-                        promise->set_exception(std::current_exception());
+        enqueue(
+            [ promise, func = std::forward<F>(f),
+              tup = std::make_tuple(std::forward<Args>(args)...) ]() mutable
+            {
+                try {
+                    if constexpr(std::is_void_v<return_type>) {
+                        std::apply(func, tup);
+                        promise->set_value();
+                    } else {
+                        auto result = std::apply(func, tup);
+                        promise->set_value(std::move(result));
                     }
+                } catch(...) {
+                    promise->set_exception(std::current_exception());
                 }
-            );
+            }
+        );
+        return future;
+    }
+
+    // Delayed and periodic tasks. A timing wheel driven by one timer thread
+    // (started on first use) keeps the pending timers; on every tick the
+    // expired ones are moved onto the task queue in a single batch, so no
+    // worker sleeps on behalf of a timer. Results are not reported back,
+    // capture whatever the task needs to publish; an exception thrown by a
+    // run is dropped and counted in stats().timers_failed.
+    template <typename Rep, typename Period, typename F>
+    timer_handle schedule_after(std::chrono::duration<Rep, Period> delay, F &&f) {
+        return schedule_at(clock::now() + delay, std::forward<F>(f));
+    }
+
+    template <typename Clock, typename Duration, typename F>
+    timer_handle schedule_at(std::chrono::time_point<Clock, Duration> when, F &&f) {
+        return add_timer(to_tick(to_steady(when)), 0,
+            [this, func = std::decay_t<F>(std::forward<F>(f))]() mutable { run_timer(func); });
+    }
+
+    // First run one period from now. Runs are not serialised: if f takes
+    // longer than the period the next run may overlap it.
+    template <typename Rep, typename Period, typename F>
+    timer_handle schedule_every(std::chrono::duration<Rep, Period> period, F &&f) {
+        uint64_t ticks = std::max<uint64_t>(1, ceil_ticks(period));
+        // periodic callbacks are copied into the queue on every run, share one
+        auto shared = std::make_shared<std::decay_t<F>>(std::forward<F>(f));
+        return add_timer(to_tick(clock::now() + period), ticks, [this, shared]() { run_timer(*shared); });
+    }
+
+    // True if the timer was still pending; a periodic timer stops repeating.
+    // A run that was already handed to the workers is not recalled.
+    bool cancel(timer_handle handle) {
+        bool res;
+        {
+            std::lock_guard<std::mutex> lock(timer_mtx);
+            res = wheel.cancel(handle);
         }
+        if (res) {
+            m_stats.add(stats::pool_counter::timers_cancelled);
+        }
+        return res;
+    }
 
-        cv.notify_one();
-        return future;
+    stats::pool_snapshot stats() const noexcept {
+        using c = stats::pool_counter;
+        stats::pool_snapshot res;
+        res.tasks_submitted = m_stats.sum(c::tasks_submitted);
+        res.tasks_completed = m_stats.sum(c::tasks_completed);
+        res.task_wait_ns = m_stats.sum(c::task_wait_ns);
+        res.task_run_ns = m_stats.sum(c::task_run_ns);
+        res.lock_acquisitions = m_stats.sum(c::lock_acquisitions);
+        res.lock_wait_ns = m_stats.sum(c::lock_wait_ns);
+        res.lock_hold_ns = m_stats.sum(c::lock_hold_ns);
+        res.max_queue_depth = m_stats.max(c::max_queue_depth);
+        res.timers_scheduled = m_stats.sum(c::timers_scheduled);
+        res.timers_fired = m_stats.sum(c::timers_fired);
+        res.timers_cancelled = m_stats.sum(c::timers_cancelled);
+        res.timers_failed = m_stats.sum(c::timers_failed);
+        res.tasks_cancelled = m_stats.sum(c::tasks_cancelled);
+        res.tasks_discarded = m_stats.sum(c::tasks_discarded);
+        return res;
     }
 
 private:
+    friend class task_group;
+
+    // queued task together with the time it was submitted
+    struct queued_task {
+        std::function<void()> func;
+        stats::stamp<> submitted;
+
+        template <typename F>
+        queued_task(F &&f) : func(std::forward<F>(f)) {}
+    };
+
+    // false (and the task is dropped) once the pool is shut down
+    template <typename F>
+    bool enqueue(F &&task) {
+        {
+            stats::timed_lock_guard<std::mutex, stats::pool_counter> lock(queue_mtx, m_stats);
+            if (stop.load(std::memory_order_relaxed)) {
+                return false;
+            }
+            task_queue.emplace(std::forward<F>(task));
+            m_stats.add(stats::pool_counter::tasks_submitted);
+            m_stats.update_max(stats::pool_counter::max_queue_depth, task_queue.size());
+        }
+        cv.notify_one();
+        return true;
+    }
+
+    void stop_timers() {
+        {
+            std::lock_guard<std::mutex> lock(timer_mtx);
+            timer_stop = true;
+        }
+        timer_cv.notify_one();
+        if (timer_thread.joinable()) {
+            timer_thread.join();
+        }
+    }
+
+    // a worker calling shutdown_now() cannot join itself, it is joined by
+    // the destructor
+    void join_workers() {
+        for (auto &i : workers) {
+            if (i.joinable() && i.get_id() != std::this_thread::get_id()) {
+                i.join();
+            }
+        }
+    }
+
+    template <typename Clock, typename Duration>
+    static clock::time_point to_steady(std::chrono::time_point<Clock, Duration> when) {
+        if constexpr (std::is_same_v<Clock, clock>) {
+            return std::chrono::time_point_cast<clock::duration>(when);
+        } else {
+            return clock::now() + std::chrono::duration_cast<clock::duration>(when - Clock::now());
+        }
+    }
+
+    template <typename Rep, typename Period>
+    static uint64_t ceil_ticks(std::chrono::duration<Rep, Period> d) {
+        auto ns = std::chrono::duration_cast<clock::duration>(d);
+        if (ns <= clock::duration::zero()) {
+            return 0;
+        }
+        return static_cast<uint64_t>((ns + timer_tick - clock::duration(1)) / timer_tick);
+    }
+
+    // first tick that ends at or after `when`
+    uint64_t to_tick(clock::time_point when) const {
+        return ceil_ticks(when - timer_epoch);
+    }
+
+    // last tick that has fully elapsed
+    uint64_t current_tick() const {
+        return static_cast<uint64_t>((clock::now() - timer_epoch) / timer_tick);
+    }
+
+    timer_handle add_timer(uint64_t tick, uint64_t period, std::function<void()> func) {
+        timer_handle res;
+        bool wake;
+        {
+            std::lock_guard<std::mutex> lock(timer_mtx);
+            if (timer_stop) {
+                return res;
+            }
+            if (!timer_thread.joinable()) {
+                timer_thread = std::thread(&thread_pool::timer_loop, this);
+            }
+            // nothing moved the wheel's clock while it was idle
+            if (wheel.empty()) {
+                wheel.skip_idle(current_tick());
+            }
+            // the timer thread only needs waking if it sleeps past this one
+            wake = std::max(tick, wheel.now() + 1) < timer_wake;
+            res = wheel.add(tick, period, std::move(func));
+        }
+        m_stats.add(stats::pool_counter::timers_scheduled);
+        if (wake) {
+            timer_cv.notify_one();
+        }
+        return res;
+    }
+
+    // nobody waits on a timer run, so an exception would otherwise escape
+    // the worker and terminate the process
+    template <typename F>
+    void run_timer(F &func) noexcept {
+        try {
+            func();
+        } catch (...) {
+            m_stats.add(stats::pool_counter::timers_failed);
+        }
+    }
+
+    void timer_loop() {
+        std::vector<std::function<void()>> expired;
+        std::unique_lock<std::mutex> lock(timer_mtx);
+        while (!timer_stop) {
+            // sleeps until the next tick with anything to fire or cascade,
+            // not every tick while timers are pending
+            timer_wake = wheel.next_tick();
+            if (timer_wake == UINT64_MAX) {
+                timer_cv.wait(lock);
+            } else {
+                timer_cv.wait_until(lock, timer_epoch + timer_tick * timer_wake);
+            }
+            if (timer_stop) {
+                break;
+            }
+            wheel.advance(current_tick(), expired);
+            if (expired.empty()) {
+                continue;
+            }
+            lock.unlock();
+            {
+                stats::timed_lock_guard<std::mutex, stats::pool_counter> queue_lock(queue_mtx, m_stats);
+                for (auto &f : expired) {
+                    task_queue.emplace(std::move(f));
+                }
+                m_stats.update_max(stats::pool_counter::max_queue_depth, task_queue.size());
+            }
+            m_stats.add(stats::pool_counter::timers_fired, expired.size());
+            if (expired.size() == 1) {
+                cv.notify_one();
+            } else {
+                cv.notify_all();
+            }
+            expired.clear();
+            lock.lock();
+        }
+    }
+
     void worker_thread() {
         while (true) {
             std::function<void()> task;
             {
+                stats::stamp<> waiting;
                 std::unique_lock<std::mutex> lock(queue_mtx);
+                m_stats.add(stats::pool_counter::lock_acquisitions);
+                m_stats.add(stats::pool_counter::lock_wait_ns, waiting.elapsed_ns());
 
                 cv.wait(lock, [this] { return !task_queue.empty() || stop; });
 
@@ -77,18 +326,37 @@ private:
                     return;
                 }
 
-                task = std::move(task_queue.front());
+                stats::stamp<> held;
+                task = std::move(task_queue.front().func);
+                m_stats.add(stats::pool_counter::task_wait_ns, task_queue.front().submitted.elapsed_ns());
                 task_queue.pop();
+                m_stats.add(stats::pool_counter::lock_hold_ns, held.elapsed_ns());
             }
+            stats::stamp<> running;
             task();
+            m_stats.add(stats::pool_counter::task_run_ns, running.elapsed_ns());
+            m_stats.add(stats::pool_counter::tasks_completed);
             cv.notify_all();
         }
     }
     size_t thread_count;
     std::mutex queue_mtx;
     std::vector<std::thread> workers;
-    std::queue<std::function<void()>> task_queue;
+    std::queue<queued_task> task_queue;
     std::condition_variable cv;
     std::atomic<bool> stop;
+    stop_source m_stop_source;
+
+    // timers, guarded by timer_mtx; the wheel counts timer_tick units from timer_epoch
+    std::mutex timer_mtx;
+    std::condition_variable timer_cv;
+    std::thread timer_thread;
+    timing_wheel wheel;
+    clock::time_point timer_epoch;
+    // tick the timer thread sleeps until, UINT64_MAX with no deadline
+    uint64_t timer_wake = UINT64_MAX;
+    bool timer_stop = false;
+
+    stats::counters<stats::pool_counter> m_stats;
 };
 } // namespace multithreaded_ds 
\ No newline at end of file
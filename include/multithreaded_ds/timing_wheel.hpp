@@ -0,0 +1,245 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace multithreaded_ds {
+
+// Hierarchical timing wheel (Varghese & Lauck) counting time in abstract
+// ticks. Four levels of 256 slots cover 2^32 ticks ahead; a timer sits in
+// the level matching how far away it is and is cascaded one level down
+// each time the level below wraps around. Timers further out than the top
+// level are parked in its farthest slot and re-placed on cascade.
+//
+// Each slot is an intrusive doubly linked list, so add and cancel are
+// O(1); advance jumps from one tick with work (see next_tick) to the next
+// and costs the timers that cascade or expire plus a scan of the slots in
+// between. Not thread safe, the owner serialises access.
+class timing_wheel {
+private:
+    struct link {
+        link *prev;
+        link *next;
+    };
+
+    struct node : link {
+        uint64_t expires = 0;
+        // 0 for one-shot timers
+        uint64_t period = 0;
+        // bumped every time the node is recycled, stale ids stop matching
+        uint64_t generation = 0;
+        std::function<void()> func;
+    };
+
+public:
+    static constexpr size_t levels = 4;
+    static constexpr size_t slot_bits = 8;
+    static constexpr size_t slots = size_t(1) << slot_bits;
+    static constexpr uint64_t slot_mask = slots - 1;
+    static constexpr uint64_t max_delta = (uint64_t(1) << (levels * slot_bits)) - 1;
+
+    class timer_id {
+    public:
+        timer_id() = default;
+        bool valid() const noexcept { return m_node != nullptr; }
+    private:
+        friend class timing_wheel;
+        timer_id(node *n, uint64_t generation) : m_node(n), m_generation(generation) {}
+
+        node *m_node = nullptr;
+        uint64_t m_generation = 0;
+    };
+
+    explicit timing_wheel(uint64_t now = 0) : m_now(now), m_size(0), m_free(nullptr) {
+        for (auto &level : m_slots) {
+            for (auto &head : level) {
+                head.prev = head.next = &head;
+            }
+        }
+    }
+
+    timing_wheel(const timing_wheel&) = delete;
+    timing_wheel& operator=(const timing_wheel&) = delete;
+
+    // Arms a timer for tick `expires` (fired on the next advance if that is
+    // already past) repeating every `period` ticks when period is non-zero.
+    timer_id add(uint64_t expires, uint64_t period, std::function<void()> func) {
+        node *n = acquire();
+        n->expires = std::max(expires, m_now + 1);
+        n->period = period;
+        n->func = std::move(func);
+        place(n);
+        ++m_size;
+        return timer_id(n, n->generation);
+    }
+
+    // Disarms a timer that has not fired yet (or a periodic one at any
+    // time); false if it already fired or was cancelled.
+    bool cancel(timer_id id) noexcept {
+        node *n = id.m_node;
+        if (n == nullptr || n->generation != id.m_generation) {
+            return false;
+        }
+        unlink(n);
+        --m_size;
+        release(n);
+        return true;
+    }
+
+    // Moves time forward to `now`, appending the callbacks of every timer
+    // that expired on the way. Periodic timers are re-armed. Stretches with
+    // nothing to fire or cascade are skipped in one step.
+    template <typename Out>
+    void advance(uint64_t now, Out &expired) {
+        while (m_now < now) {
+            uint64_t next = next_tick();
+            if (next > now) {
+                m_now = now;
+                break;
+            }
+            m_now = next;
+            // cascade the upper levels whose slot boundary was just crossed
+            for (size_t level = 1; level < levels; ++level) {
+                if (((m_now >> ((level - 1) * slot_bits)) & slot_mask) != 0) {
+                    break;
+                }
+                cascade(level, (m_now >> (level * slot_bits)) & slot_mask);
+            }
+            link &head = m_slots[0][m_now & slot_mask];
+            while (head.next != &head) {
+                node *n = static_cast<node*>(head.next);
+                unlink(n);
+                if (n->period != 0) {
+                    expired.push_back(n->func);
+                    n->expires = m_now + n->period;
+                    place(n);
+                } else {
+                    expired.push_back(std::move(n->func));
+                    --m_size;
+                    release(n);
+                }
+            }
+        }
+    }
+
+    // First tick after now() at which advance() has work: a level 0 slot to
+    // fire or a non-empty upper slot to cascade. A lower bound for the next
+    // expiry, so the owner can sleep until then. UINT64_MAX when empty.
+    uint64_t next_tick() const noexcept {
+        uint64_t res = UINT64_MAX;
+        if (m_size == 0) {
+            return res;
+        }
+        for (uint64_t d = 1; d < slots; ++d) {
+            if (!slot_empty(0, m_now + d)) {
+                res = m_now + d;
+                break;
+            }
+        }
+        // upper slot i of a level is cascaded when the tick reaches a
+        // multiple of that level's span with i in its digit
+        for (size_t level = 1; level < levels; ++level) {
+            size_t shift = level * slot_bits;
+            for (uint64_t k = 1; k <= slots; ++k) {
+                uint64_t boundary = ((m_now >> shift) + k) << shift;
+                if (boundary >= res) {
+                    break;
+                }
+                if (!slot_empty(level, boundary >> shift)) {
+                    res = boundary;
+                    break;
+                }
+            }
+        }
+        return res;
+    }
+
+    // Moves the clock of an empty wheel to `now` without walking the ticks
+    // in between, so a timer armed after an idle stretch is placed relative
+    // to the current time. No-op while timers are pending.
+    void skip_idle(uint64_t now) noexcept {
+        if (m_size == 0 && now > m_now) {
+            m_now = now;
+        }
+    }
+
+    uint64_t now() const noexcept { return m_now; }
+    size_t size() const noexcept { return m_size; }
+    bool empty() const noexcept { return m_size == 0; }
+
+private:
+    bool slot_empty(size_t level, uint64_t index) const noexcept {
+        const link &head = m_slots[level][index & slot_mask];
+        return head.next == &head;
+    }
+
+    void place(node *n) noexcept {
+        uint64_t delta = n->expires - m_now;
+        uint64_t expires = delta > max_delta ? m_now + max_delta : n->expires;
+        delta = expires - m_now;
+        size_t level = 0;
+        while (level + 1 < levels && delta >= (uint64_t(1) << ((level + 1) * slot_bits))) {
+            ++level;
+        }
+        link &head = m_slots[level][(expires >> (level * slot_bits)) & slot_mask];
+        n->prev = head.prev;
+        n->next = &head;
+        head.prev->next = n;
+        head.prev = n;
+    }
+
+    void cascade(size_t level, uint64_t slot) noexcept {
+        link &head = m_slots[level][slot];
+        link *first = head.next;
+        head.prev = head.next = &head;
+        while (first != &head) {
+            node *n = static_cast<node*>(first);
+            first = first->next;
+            place(n);
+        }
+    }
+
+    static void unlink(node *n) noexcept {
+        n->prev->next = n->next;
+        n->next->prev = n->prev;
+        n->prev = n->next = nullptr;
+    }
+
+    node* acquire() {
+        if (m_free == nullptr) {
+            constexpr size_t chunk = 256;
+            m_chunks.emplace_back(new node[chunk]);
+            node *nodes = m_chunks.back().get();
+            for (size_t i = 0; i < chunk; ++i) {
+                nodes[i].prev = nullptr;
+                nodes[i].next = i + 1 < chunk ? &nodes[i + 1] : nullptr;
+            }
+            m_free = nodes;
+        }
+        node *n = m_free;
+        m_free = static_cast<node*>(n->next);
+        return n;
+    }
+
+    // free nodes are chained through next with prev left null
+    void release(node *n) noexcept {
+        n->func = nullptr;
+        ++n->generation;
+        n->prev = nullptr;
+        n->next = m_free;
+        m_free = n;
+    }
+
+    link m_slots[levels][slots];
+    uint64_t m_now;
+    size_t m_size;
+    node *m_free;
+    std::vector<std::unique_ptr<node[]>> m_chunks;
+};
+
+} // namespace multithreaded_ds
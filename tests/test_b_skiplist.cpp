@@ -0,0 +1,163 @@
+#include "../include/multithreaded_ds/b_skiplist.hpp"
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <set>
+#include <random>
+#include <cstdint>
+#include <string>
+#include <stdexcept>
+
+class TestException : public std::runtime_error {
+public:
+    TestException(const std::string& message) : std::runtime_error(message) {}
+};
+
+// random add/erase/search mix checked against std::set
+template <typename T, size_t B>
+void check_against_set(const std::string& name, T lo, T hi) {
+    multithreaded_ds::BSkiplist<T, B> list;
+    std::set<T> reference;
+    std::mt19937_64 rng(7);
+    std::uniform_int_distribution<int64_t> pick(static_cast<int64_t>(lo), static_cast<int64_t>(hi));
+
+    for (int i = 0; i < 200000; ++i) {
+        T key = static_cast<T>(pick(rng));
+        switch (rng() % 4) {
+        case 0:
+        case 1:
+            if (list.add(key) != reference.insert(key).second) {
+                throw TestException(name + ": add disagrees with std::set");
+            }
+            break;
+        case 2:
+            if (list.erase(key) != (reference.erase(key) == 1)) {
+                throw TestException(name + ": erase disagrees with std::set");
+            }
+            break;
+        default:
+            if (list.search(key) != (reference.count(key) == 1)) {
+                throw TestException(name + ": search disagrees with std::set");
+            }
+        }
+    }
+    if (list.size() != reference.size()) {
+        throw TestException(name + ": size mismatch");
+    }
+    for (T key : reference) {
+        if (!list.search(key)) {
+            throw TestException(name + ": key lost");
+        }
+    }
+}
+
+// ascending appends, then erasing three keys in four, then refilling the
+// gaps: the tail-append and merge paths
+void test_sequential() {
+    multithreaded_ds::BSkiplist<int64_t, 4> list;
+    const int64_t n = 50000;
+    for (int64_t i = 0; i < n; ++i) {
+        if (!list.add(i)) {
+            throw TestException("Ascending add failed");
+        }
+    }
+    for (int64_t i = 0; i < n; ++i) {
+        if (i % 4 != 0 && !list.erase(i)) {
+            throw TestException("Erase of a present key failed");
+        }
+    }
+    for (int64_t i = 0; i < n; ++i) {
+        if (list.search(i) != (i % 4 == 0)) {
+            throw TestException("Wrong key set after erasing");
+        }
+    }
+    for (int64_t i = n - 1; i >= 0; --i) {
+        if (list.add(i) != (i % 4 != 0)) {
+            throw TestException("Refill add disagrees");
+        }
+    }
+    if (list.size() != static_cast<size_t>(n)) {
+        throw TestException("Size mismatch after refill");
+    }
+    for (int64_t i = 0; i < n; ++i) {
+        if (!list.search(i)) {
+            throw TestException("Key lost after refill");
+        }
+    }
+}
+
+void test_extremes() {
+    multithreaded_ds::BSkiplist<int64_t> list;
+    const int64_t max = std::numeric_limits<int64_t>::max();
+    const int64_t min = std::numeric_limits<int64_t>::min();
+    if (list.search(max) || list.search(min)) {
+        throw TestException("Empty list finds padding keys");
+    }
+    list.add(max);
+    list.add(min);
+    list.add(0);
+    if (!list.search(max) || !list.search(min) || !list.search(0) || list.search(1)) {
+        throw TestException("Extreme keys not handled");
+    }
+
+    multithreaded_ds::BSkiplist<double> doubles;
+    doubles.add(-1.5);
+    doubles.add(std::numeric_limits<double>::infinity());
+    if (!doubles.search(-1.5) || !doubles.search(std::numeric_limits<double>::infinity()) || doubles.search(0.0)) {
+        throw TestException("Floating point keys not handled");
+    }
+}
+
+void test_concurrent() {
+    multithreaded_ds::BSkiplist<int32_t> list;
+    const int num_threads = 4;
+    const int per_thread = 20000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < per_thread; ++i) {
+                list.add(i * num_threads + t);
+                list.search(i);
+            }
+        });
+    }
+    for (auto& th : threads) {
+        th.join();
+    }
+    if (list.size() != static_cast<size_t>(num_threads * per_thread)) {
+        throw TestException("Concurrent adds lost keys");
+    }
+    for (int i = 0; i < num_threads * per_thread; ++i) {
+        if (!list.search(i)) {
+            throw TestException("Key missing after concurrent adds");
+        }
+    }
+}
+
+int main() {
+    try {
+        std::cout << "Testing against std::set..." << std::endl;
+        check_against_set<int64_t, 4>("int64/4", -5000, 5000);
+        check_against_set<int64_t, 16>("int64/16", -100000, 100000);
+        check_against_set<int32_t, 32>("int32/32", 0, 50000);
+        check_against_set<uint32_t, 8>("uint32/8", 0, 20000);
+        check_against_set<double, 16>("double/16", -30000, 30000);
+        check_against_set<float, 8>("float/8", 0, 3000);
+        check_against_set<int16_t, 64>("int16/64", -2000, 2000);
+
+        std::cout << "\nTesting sequential adds and erases..." << std::endl;
+        test_sequential();
+
+        std::cout << "\nTesting extreme keys..." << std::endl;
+        test_extremes();
+
+        std::cout << "\nTesting concurrent adds..." << std::endl;
+        test_concurrent();
+
+        std::cout << "\nAll tests passed successfully!" << std::endl;
+        return 0;
+    } catch (const TestException& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
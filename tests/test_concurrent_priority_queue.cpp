@@ -0,0 +1,117 @@
+#include "../include/multithreaded_ds/concurrent_priority_queue.hpp"
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+
+class TestException : public std::runtime_error {
+public:
+    TestException(const std::string& message) : std::runtime_error(message) {}
+};
+
+void test_single_thread() {
+    multithreaded_ds::concurrent_priority_queue<int> queue;
+
+    for (int value : {5, 3, 7, 1, 9, 3}) {
+        queue.push(value);
+    }
+    if (queue.size() != 6) {
+        throw TestException("Unexpected size after pushes");
+    }
+
+    int value;
+    for (int expected : {1, 3, 3, 5, 7, 9}) {
+        if (!queue.try_pop_min(value) || value != expected) {
+            throw TestException("Elements not popped in priority order");
+        }
+    }
+    if (queue.try_pop_min(value) || queue.pop_approx_min(value)) {
+        throw TestException("Popped from an empty queue");
+    }
+}
+
+void test_approx_pop_drains() {
+    multithreaded_ds::concurrent_priority_queue<int> queue(8);
+    const int count = 10000;
+
+    for (int i = 0; i < count; ++i) {
+        queue.push(i);
+    }
+
+    // Relaxed pops may reorder but never lose or duplicate elements
+    std::vector<int> popped;
+    int value;
+    while (queue.pop_approx_min(value)) {
+        popped.push_back(value);
+    }
+    std::sort(popped.begin(), popped.end());
+    if (popped.size() != count || std::adjacent_find(popped.begin(), popped.end()) != popped.end()) {
+        throw TestException("Approximate pops lost or duplicated elements");
+    }
+}
+
+void test_concurrent_push_pop() {
+    multithreaded_ds::concurrent_priority_queue<int> queue(4);
+    const int num_threads = 4;
+    const int elements_per_thread = 5000;
+    std::vector<std::thread> threads;
+    std::vector<int> popped;
+    std::mutex popped_mutex;
+
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&, i]() {
+            std::vector<int> local;
+            int value;
+            for (int j = 0; j < elements_per_thread; ++j) {
+                queue.push(i * elements_per_thread + j);
+                bool got = (j % 2 == 0) ? queue.try_pop_min(value) : queue.pop_approx_min(value);
+                if (got) {
+                    local.push_back(value);
+                }
+            }
+            std::lock_guard<std::mutex> lock(popped_mutex);
+            popped.insert(popped.end(), local.begin(), local.end());
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    int value;
+    while (queue.try_pop_min(value)) {
+        popped.push_back(value);
+    }
+
+    std::sort(popped.begin(), popped.end());
+    if (popped.size() != num_threads * elements_per_thread) {
+        throw TestException("Lost elements under concurrent push/pop");
+    }
+    for (int i = 0; i < num_threads * elements_per_thread; ++i) {
+        if (popped[i] != i) {
+            throw TestException("Duplicated elements under concurrent push/pop");
+        }
+    }
+    std::cout << "Total values popped: " << popped.size() << std::endl;
+}
+
+int main() {
+    try {
+        std::cout << "Testing single thread operations..." << std::endl;
+        test_single_thread();
+
+        std::cout << "\nTesting approximate pops..." << std::endl;
+        test_approx_pop_drains();
+
+        std::cout << "\nTesting concurrent push and pop..." << std::endl;
+        test_concurrent_push_pop();
+
+        std::cout << "\nAll tests passed successfully!" << std::endl;
+        return 0;
+    } catch (const TestException& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -5,6 +5,14 @@
 #include <chrono>
 #include <random>
 #include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+class TestException : public std::runtime_error {
+public:
+    TestException(const std::string& message) : std::runtime_error(message) {}
+};
 
 void test_single_thread() {
     multithreaded_ds::concurrent_queue<int> queue;
@@ -176,18 +184,107 @@ void test_rapid_concurrent_operations() {
     std::cout << "Final queue size: " << queue.size() << std::endl;
 }
 
+void test_wait_pop_and_close() {
+    multithreaded_ds::concurrent_queue<int> queue;
+    const int num_producers = 3;
+    const int num_consumers = 3;
+    const int elements_per_producer = 1000;
+    std::atomic<int> total_consumed{0};
+    std::vector<std::thread> producers;
+    std::vector<std::thread> consumers;
+
+    // Consumers block instead of polling and exit once the queue is closed and drained
+    for (int i = 0; i < num_consumers; ++i) {
+        consumers.emplace_back([&queue, &total_consumed]() {
+            int value;
+            while (queue.wait_pop(value)) {
+                total_consumed++;
+            }
+        });
+    }
+
+    for (int i = 0; i < num_producers; ++i) {
+        producers.emplace_back([&queue, i]() {
+            for (int j = 0; j < elements_per_producer; ++j) {
+                queue.push(i * elements_per_producer + j);
+                if (j % 100 == 0) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            }
+        });
+    }
+
+    for (auto& thread : producers) {
+        thread.join();
+    }
+    queue.close();
+    for (auto& thread : consumers) {
+        thread.join();
+    }
+
+    std::cout << "Total values consumed: " << total_consumed << std::endl;
+    if (total_consumed != num_producers * elements_per_producer) {
+        throw TestException("Consumers did not drain the closed queue");
+    }
+    if (queue.push(1)) {
+        throw TestException("Push accepted after close");
+    }
+
+    // A timed wait on an empty queue gives up after the timeout
+    multithreaded_ds::concurrent_queue<int> empty_queue;
+    int value;
+    auto start = std::chrono::steady_clock::now();
+    bool got = empty_queue.wait_pop_for(value, std::chrono::milliseconds(20));
+    auto waited = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    std::cout << "Timed wait returned " << got << " after " << waited.count() << " ms" << std::endl;
+    if (got || waited < std::chrono::milliseconds(20)) {
+        throw TestException("Timed wait on an empty queue did not time out");
+    }
+}
+
+void test_move_only() {
+    multithreaded_ds::concurrent_queue<std::unique_ptr<int>> queue;
+
+    // Elements are moved in and out, never copied
+    queue.push(std::make_unique<int>(1));
+    queue.emplace(new int(2));
+    auto front = queue.pop();
+    if (front && *front) {
+        std::cout << "Popped value: " << **front << std::endl;
+    }
+    std::unique_ptr<int> value;
+    if (queue.pop(value)) {
+        std::cout << "Popped value: " << *value << std::endl;
+    }
+    if (!queue.pop()) {
+        std::cout << "Queue is empty as expected" << std::endl;
+    }
+}
+
 int main() {
-    std::cout << "Testing single thread operations..." << std::endl;
-    test_single_thread();
-    
-    std::cout << "\nTesting multi-thread operations..." << std::endl;
-    test_multi_thread();
-    
-    std::cout << "\nTesting concurrent producer-consumer scenario..." << std::endl;
-    test_concurrent_producer_consumer();
-    
-    std::cout << "\nTesting rapid concurrent operations..." << std::endl;
-    test_rapid_concurrent_operations();
-    
-    return 0;
+    try {
+        std::cout << "Testing single thread operations..." << std::endl;
+        test_single_thread();
+
+        std::cout << "\nTesting multi-thread operations..." << std::endl;
+        test_multi_thread();
+
+        std::cout << "\nTesting concurrent producer-consumer scenario..." << std::endl;
+        test_concurrent_producer_consumer();
+
+        std::cout << "\nTesting rapid concurrent operations..." << std::endl;
+        test_rapid_concurrent_operations();
+
+        std::cout << "\nTesting blocking pop and close..." << std::endl;
+        test_wait_pop_and_close();
+
+        std::cout << "\nTesting move-only elements..." << std::endl;
+        test_move_only();
+
+        std::cout << "\nAll tests passed successfully!" << std::endl;
+        return 0;
+    } catch (const TestException& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
 }
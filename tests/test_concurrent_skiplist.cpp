@@ -1,4 +1,5 @@
 #include "../include/multithreaded_ds/concurrent_skiplist.hpp"
+#include "../include/multithreaded_ds/skiplist_io.hpp"
 #include <iostream>
 #include <thread>
 #include <vector>
@@ -8,6 +9,9 @@
 #include <algorithm>
 #include <stdexcept>
 #include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <string>
 
 class TestException : public std::runtime_error {
 public:
@@ -200,6 +204,177 @@ void test_rapid_concurrent_searches() {
     std::cout << "Total successful searches: " << successful_searches << std::endl;
 }
 
+void test_snapshot_isolation() {
+    multithreaded_ds::Skiplist<int> skiplist;
+    for (int i = 0; i < 100; ++i) {
+        skiplist.add(i);
+    }
+
+    auto snap = skiplist.snapshot();
+
+    // Writes after the snapshot are invisible to it
+    skiplist.add(1000);
+    skiplist.erase(10);
+    skiplist.erase(20);
+    if (skiplist.search(10) || !skiplist.search(1000)) {
+        throw TestException("Live view not updated by writes");
+    }
+    if (!snap.contains(10) || snap.contains(1000)) {
+        throw TestException("Snapshot sees writes made after it was taken");
+    }
+
+    int count = 0;
+    int expected = 0;
+    decltype(snap)::iterator it(snap);
+    for (it.seek_to_first(); it.valid(); it.next()) {
+        if (it.value() != expected++) {
+            throw TestException("Snapshot iteration out of order");
+        }
+        ++count;
+    }
+    if (count != 100) {
+        throw TestException("Snapshot iteration saw the wrong number of entries");
+    }
+
+    // Re-adding an erased key is a new version
+    skiplist.add(10);
+    auto later = skiplist.snapshot();
+    if (!later.contains(10) || later.contains(20)) {
+        throw TestException("Second snapshot has the wrong contents");
+    }
+}
+
+void test_snapshot_scan_during_writes() {
+    multithreaded_ds::Skiplist<int> skiplist;
+    const int num_keys = 5000;
+    for (int i = 0; i < num_keys; ++i) {
+        skiplist.add(i * 2);
+    }
+
+    std::atomic<bool> done{false};
+    std::atomic<bool> inconsistent{false};
+    std::atomic<int> scans{0};
+
+    // Writers keep inserting odd keys and erasing even ones while readers scan
+    std::thread writer([&]() {
+        for (int i = 0; i < num_keys; ++i) {
+            skiplist.add(i * 2 + 1);
+            skiplist.erase(i * 2);
+        }
+        done = true;
+    });
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&]() {
+            while (!done) {
+                auto snap = skiplist.snapshot();
+                int count = 0;
+                int last = -1;
+                decltype(snap)::iterator it(snap);
+                for (it.seek_to_first(); it.valid(); it.next()) {
+                    if (it.value() <= last) {
+                        inconsistent = true;
+                    }
+                    last = it.value();
+                    ++count;
+                }
+                // every add is paired with an erase, so a consistent view
+                // always holds num_keys or num_keys + 1 entries
+                if (count != num_keys && count != num_keys + 1) {
+                    inconsistent = true;
+                }
+                scans++;
+            }
+        });
+    }
+
+    writer.join();
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    if (inconsistent) {
+        throw TestException("Snapshot scan saw an inconsistent view");
+    }
+    for (int i = 0; i < num_keys; ++i) {
+        if (skiplist.search(i * 2) || !skiplist.search(i * 2 + 1)) {
+            throw TestException("Wrong contents after snapshot garbage collection");
+        }
+    }
+    std::cout << "Consistent snapshot scans: " << scans << std::endl;
+}
+
+void test_save_and_load() {
+    const std::string path = "test_skiplist_save.bin";
+    const int num_keys = 10000;
+    {
+        multithreaded_ds::Skiplist<long> skiplist;
+        for (int i = 0; i < num_keys; ++i) {
+            skiplist.add(static_cast<long>(i) * 3);
+        }
+        skiplist.erase(300);
+        if (!multithreaded_ds::save_to(skiplist, path)) {
+            throw TestException("Failed to save skiplist");
+        }
+    }
+
+    multithreaded_ds::Skiplist<long> loaded;
+    if (!multithreaded_ds::load_from(loaded, path)) {
+        throw TestException("Failed to load skiplist");
+    }
+    if (multithreaded_ds::load_from(loaded, path)) {
+        throw TestException("Loaded into a non-empty skiplist");
+    }
+    for (int i = 0; i < num_keys; ++i) {
+        bool expected = i != 100;
+        if (loaded.search(static_cast<long>(i) * 3) != expected || loaded.search(static_cast<long>(i) * 3 + 1)) {
+            throw TestException("Loaded skiplist has the wrong contents");
+        }
+    }
+
+    // The loaded list keeps working as a normal skiplist
+    loaded.add(1);
+    if (!loaded.erase(3) || !loaded.search(1) || loaded.search(3)) {
+        throw TestException("Loaded skiplist does not accept updates");
+    }
+
+    // Files for another key type are rejected
+    multithreaded_ds::Skiplist<int> wrong_type;
+    if (multithreaded_ds::load_from(wrong_type, path) || multithreaded_ds::load_from(wrong_type, "does_not_exist.bin")) {
+        throw TestException("Loaded an incompatible or missing file");
+    }
+
+    // Trailing bytes and out-of-order keys are rejected, the list stays empty
+    std::FILE* file = std::fopen(path.c_str(), "ab");
+    std::fputc(0, file);
+    std::fclose(file);
+    multithreaded_ds::Skiplist<long> padded;
+    if (multithreaded_ds::load_from(padded, path) || padded.search(3)) {
+        throw TestException("Loaded a file with trailing garbage");
+    }
+
+    multithreaded_ds::skiplist_file_header header{};
+    std::memcpy(header.magic, multithreaded_ds::skiplist_file_magic, sizeof(header.magic));
+    header.format_version = multithreaded_ds::skiplist_file_format_version;
+    header.key_size = sizeof(long);
+    header.count = 3;
+    const long unsorted[3] = {1, 5, 2};
+    file = std::fopen(path.c_str(), "wb");
+    std::fwrite(&header, sizeof(header), 1, file);
+    std::fwrite(unsorted, sizeof(long), 3, file);
+    std::fclose(file);
+    multithreaded_ds::Skiplist<long> shuffled;
+    if (multithreaded_ds::load_from(shuffled, path) || shuffled.search(1)) {
+        throw TestException("Loaded a file with keys out of order");
+    }
+    // the rejected load leaves a working, empty list
+    shuffled.add(4);
+    if (!shuffled.search(4)) {
+        throw TestException("Skiplist unusable after a rejected load");
+    }
+    std::remove(path.c_str());
+}
+
 int main() {
     try {
         std::cout << "Testing single thread operations..." << std::endl;
@@ -213,6 +388,15 @@ int main() {
         
         std::cout << "\nTesting rapid concurrent searches..." << std::endl;
         test_rapid_concurrent_searches();
+
+        std::cout << "\nTesting snapshot isolation..." << std::endl;
+        test_snapshot_isolation();
+
+        std::cout << "\nTesting snapshot scans during writes..." << std::endl;
+        test_snapshot_scan_during_writes();
+
+        std::cout << "\nTesting save and load..." << std::endl;
+        test_save_and_load();
         
         std::cout << "\nAll tests passed successfully!" << std::endl;
         return 0;
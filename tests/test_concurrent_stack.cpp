@@ -2,6 +2,7 @@
 #include <iostream>
 #include <thread>
 #include <vector>
+#include <memory>
 
 void test_single_thread() {
     multithreaded_ds::concurrent_stack<int> stack;
@@ -45,12 +46,34 @@ void test_multi_thread() {
     std::cout << "Stack size after clear: " << stack.size() << std::endl;
 }
 
+void test_move_only() {
+    multithreaded_ds::concurrent_stack<std::unique_ptr<int>> stack;
+
+    // Elements are moved in and out, never copied
+    stack.push(std::make_unique<int>(1));
+    stack.emplace(new int(2));
+    auto top = stack.pop();
+    if (top && *top) {
+        std::cout << "Popped value: " << **top << std::endl;
+    }
+    std::unique_ptr<int> value;
+    if (stack.pop(value)) {
+        std::cout << "Popped value: " << *value << std::endl;
+    }
+    if (!stack.pop()) {
+        std::cout << "Stack is empty as expected" << std::endl;
+    }
+}
+
 int main() {
     std::cout << "Testing single thread operations..." << std::endl;
     test_single_thread();
     
     std::cout << "\nTesting multi-thread operations..." << std::endl;
     test_multi_thread();
+
+    std::cout << "\nTesting move-only elements..." << std::endl;
+    test_move_only();
     
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,155 @@
+#include "../include/multithreaded_ds/flat_combining.hpp"
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+
+class TestException : public std::runtime_error {
+public:
+    TestException(const std::string& message) : std::runtime_error(message) {}
+};
+
+using multithreaded_ds::fc::op;
+
+void test_single_thread() {
+    multithreaded_ds::flat_combining<multithreaded_ds::fc::skiplist_ops<int>> list;
+
+    list.execute({op::add, 5});
+    list.execute({op::add, 3});
+    list.execute({op::add, 7});
+    if (!list.execute({op::search, 5}).result || list.execute({op::search, 4}).result) {
+        throw TestException("Search through the combiner returned a wrong result");
+    }
+    if (!list.execute({op::erase, 3}).result || list.execute({op::erase, 3}).result) {
+        throw TestException("Erase through the combiner returned a wrong result");
+    }
+
+    multithreaded_ds::flat_combining<multithreaded_ds::fc::queue_ops<int>> queue;
+    queue.execute({op::push, 1});
+    queue.execute({op::push, 2});
+    auto first = queue.execute({op::pop});
+    if (!first.result || first.value != 1) {
+        throw TestException("Queue through the combiner is not FIFO");
+    }
+}
+
+void test_skiplist_finger_batch() {
+    multithreaded_ds::Skiplist<int> skiplist;
+
+    // Sorted batch applied in one pass, interleaving adds, erases and searches
+    skiplist.batch([](auto& finger) {
+        for (int i = 0; i < 1000; ++i) {
+            finger.add(i * 2);
+        }
+    });
+    bool ok = true;
+    skiplist.batch([&ok](auto& finger) {
+        for (int i = 0; i < 1000; ++i) {
+            if (i % 2 == 0) {
+                ok = ok && finger.erase(i * 2);
+            } else {
+                ok = ok && finger.search(i * 2);
+            }
+            ok = ok && !finger.search(i * 2 + 1);
+        }
+    });
+    if (!ok) {
+        throw TestException("Finger operations returned a wrong result");
+    }
+    for (int i = 0; i < 1000; ++i) {
+        if (skiplist.search(i * 2) != (i % 2 == 1)) {
+            throw TestException("Skiplist contents wrong after finger batch");
+        }
+    }
+}
+
+template <typename Ops>
+void run_push_pop(const char* name) {
+    multithreaded_ds::flat_combining<Ops> ds;
+    const int num_threads = 8;
+    const int elements_per_thread = 2000;
+    std::vector<std::thread> threads;
+    std::vector<int> popped;
+    std::mutex popped_mutex;
+
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&, i]() {
+            std::vector<int> local;
+            for (int j = 0; j < elements_per_thread; ++j) {
+                ds.execute({op::push, i * elements_per_thread + j});
+                auto r = ds.execute({op::pop});
+                if (r.result) {
+                    local.push_back(r.value);
+                }
+            }
+            std::lock_guard<std::mutex> lock(popped_mutex);
+            popped.insert(popped.end(), local.begin(), local.end());
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    int value;
+    while (ds.underlying().pop(value)) {
+        popped.push_back(value);
+    }
+
+    std::sort(popped.begin(), popped.end());
+    for (int i = 0; i < num_threads * elements_per_thread; ++i) {
+        if (i >= static_cast<int>(popped.size()) || popped[i] != i) {
+            throw TestException(std::string("Lost or duplicated elements in combined ") + name);
+        }
+    }
+    std::cout << "Combined " << name << " values popped: " << popped.size() << std::endl;
+}
+
+void test_concurrent_skiplist() {
+    multithreaded_ds::flat_combining<multithreaded_ds::fc::skiplist_ops<int>> list;
+    const int num_threads = 8;
+    const int elements_per_thread = 1000;
+    std::vector<std::thread> threads;
+    std::atomic<int> found{0};
+
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&, i]() {
+            for (int j = 0; j < elements_per_thread; ++j) {
+                int key = j * num_threads + i;
+                list.execute({op::add, key});
+                if (list.execute({op::search, key}).result) {
+                    found++;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    if (found != num_threads * elements_per_thread) {
+        throw TestException("Added keys not found through the combiner");
+    }
+    std::cout << "Combined skiplist keys found: " << found << std::endl;
+}
+
+int main() {
+    try {
+        std::cout << "Testing single thread operations..." << std::endl;
+        test_single_thread();
+
+        std::cout << "\nTesting skiplist finger batches..." << std::endl;
+        test_skiplist_finger_batch();
+
+        std::cout << "\nTesting concurrent combined operations..." << std::endl;
+        run_push_pop<multithreaded_ds::fc::stack_ops<int>>("stack");
+        run_push_pop<multithreaded_ds::fc::queue_ops<int>>("queue");
+        test_concurrent_skiplist();
+
+        std::cout << "\nAll tests passed successfully!" << std::endl;
+        return 0;
+    } catch (const TestException& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,104 @@
+#include "../include/multithreaded_ds/intrusive_queue.hpp"
+#include "../include/multithreaded_ds/intrusive_stack.hpp"
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <stdexcept>
+
+class TestException : public std::runtime_error {
+public:
+    TestException(const std::string& message) : std::runtime_error(message) {}
+};
+
+struct queue_tag {};
+struct stack_tag {};
+
+// 64-byte message that can sit in a queue and a stack at the same time
+struct message : multithreaded_ds::intrusive_hook<queue_tag>,
+                 multithreaded_ds::intrusive_hook<stack_tag> {
+    int id = 0;
+    char payload[44] = {};
+};
+
+void test_single_thread() {
+    multithreaded_ds::intrusive_queue<message, queue_tag> queue;
+    multithreaded_ds::intrusive_stack<message, stack_tag> stack;
+    std::vector<message> messages(10);
+
+    for (int i = 0; i < 10; ++i) {
+        messages[i].id = i;
+        queue.push(messages[i]);
+        stack.push(messages[i]);
+    }
+    if (queue.size() != 10 || stack.size() != 10) {
+        throw TestException("Unexpected size after pushes");
+    }
+
+    for (int i = 0; i < 10; ++i) {
+        message* from_queue = queue.pop();
+        message* from_stack = stack.pop();
+        if (from_queue != &messages[i]) {
+            throw TestException("Queue did not return the linked object in FIFO order");
+        }
+        if (from_stack != &messages[9 - i]) {
+            throw TestException("Stack did not return the linked object in LIFO order");
+        }
+    }
+    if (queue.pop() != nullptr || stack.pop() != nullptr) {
+        throw TestException("Popped from an empty container");
+    }
+}
+
+void test_multi_thread() {
+    multithreaded_ds::intrusive_queue<message, queue_tag> queue;
+    const int num_threads = 4;
+    const int elements_per_thread = 1000;
+    std::vector<message> messages(num_threads * elements_per_thread);
+    std::vector<std::thread> threads;
+    std::atomic<int> total_consumed{0};
+
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&queue, &messages, i]() {
+            for (int j = 0; j < elements_per_thread; ++j) {
+                queue.push(messages[i * elements_per_thread + j]);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    threads.clear();
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&queue, &total_consumed]() {
+            while (queue.pop() != nullptr) {
+                total_consumed++;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (total_consumed != num_threads * elements_per_thread) {
+        throw TestException("Lost or duplicated elements");
+    }
+    std::cout << "Total values consumed: " << total_consumed << std::endl;
+}
+
+int main() {
+    try {
+        std::cout << "Testing single thread operations..." << std::endl;
+        test_single_thread();
+
+        std::cout << "\nTesting multi-thread operations..." << std::endl;
+        test_multi_thread();
+
+        std::cout << "\nAll tests passed successfully!" << std::endl;
+        return 0;
+    } catch (const TestException& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
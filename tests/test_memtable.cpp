@@ -0,0 +1,155 @@
+#include "../include/multithreaded_ds/memtable.hpp"
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <string>
+#include <cstdio>
+#include <stdexcept>
+
+class TestException : public std::runtime_error {
+public:
+    TestException(const std::string& message) : std::runtime_error(message) {}
+};
+
+std::string make_key(int i) {
+    char buf[16];
+    std::snprintf(buf, sizeof(buf), "key%08d", i);
+    return buf;
+}
+
+// orders keys by length first, then bytes
+struct length_first_comparator {
+    int operator()(std::string_view a, std::string_view b) const noexcept {
+        if (a.size() != b.size()) return a.size() < b.size() ? -1 : 1;
+        return a.compare(b);
+    }
+};
+
+void test_single_thread() {
+    multithreaded_ds::memtable<> table;
+
+    if (!table.add("banana", "yellow") || !table.add("apple", "red") || !table.add("cherry", "dark red")) {
+        throw TestException("Failed to add a new key");
+    }
+    if (table.add("apple", "green")) {
+        throw TestException("Added a duplicate key");
+    }
+
+    auto value = table.get("apple");
+    if (!value || *value != "red") {
+        throw TestException("Wrong value for an existing key");
+    }
+    if (table.get("durian") || table.contains("apricot")) {
+        throw TestException("Found a key that was never added");
+    }
+
+    // Keys with embedded zero bytes are plain byte slices
+    std::string binary("a\0b", 3);
+    table.add(binary, std::string("\0\1", 2));
+    if (!table.contains(binary) || table.get(binary)->size() != 2) {
+        throw TestException("Binary key or value was not stored verbatim");
+    }
+
+    std::string order;
+    multithreaded_ds::memtable<>::iterator it(table);
+    for (it.seek_to_first(); it.valid(); it.next()) {
+        order += std::string(it.key()) + " ";
+    }
+    std::cout << "Iteration order: " << order << std::endl;
+
+    it.seek("b");
+    if (!it.valid() || it.key() != "banana") {
+        throw TestException("Seek did not land on the first key >= target");
+    }
+    if (table.memory_usage() == 0) {
+        throw TestException("Memory usage not tracked");
+    }
+}
+
+void test_custom_comparator() {
+    multithreaded_ds::memtable<length_first_comparator> table;
+    for (auto key : {"ccc", "a", "bb", "zz", "b"}) {
+        table.add(key);
+    }
+    std::string order;
+    multithreaded_ds::memtable<length_first_comparator>::iterator it(table);
+    for (it.seek_to_first(); it.valid(); it.next()) {
+        order += std::string(it.key()) + " ";
+    }
+    if (order != "a b bb zz ccc ") {
+        throw TestException("Custom comparator order not respected: " + order);
+    }
+}
+
+void test_concurrent_readers() {
+    multithreaded_ds::memtable<> table;
+    const int num_keys = 20000;
+    const int num_readers = 4;
+    std::atomic<int> written{0};
+    std::atomic<bool> wrong{false};
+    std::vector<std::thread> threads;
+
+    // One writer, lock-free readers checking every key published so far
+    threads.emplace_back([&]() {
+        for (int i = 0; i < num_keys; ++i) {
+            table.add(make_key(i), std::to_string(i));
+            written.store(i + 1, std::memory_order_release);
+        }
+    });
+    for (int r = 0; r < num_readers; ++r) {
+        threads.emplace_back([&, r]() {
+            int checked = 0;
+            while (checked < num_keys) {
+                int limit = written.load(std::memory_order_acquire);
+                for (; checked < limit; ++checked) {
+                    int i = (checked * 7 + r) % limit;
+                    auto value = table.get(make_key(i));
+                    if (!value || *value != std::to_string(i)) {
+                        wrong = true;
+                    }
+                }
+                std::this_thread::yield();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    if (wrong) {
+        throw TestException("Reader missed a published key");
+    }
+
+    int count = 0;
+    std::string last;
+    multithreaded_ds::memtable<>::iterator it(table);
+    for (it.seek_to_first(); it.valid(); it.next(), ++count) {
+        if (!last.empty() && std::string(it.key()) <= last) {
+            throw TestException("Iteration out of order");
+        }
+        last = std::string(it.key());
+    }
+    if (count != num_keys || table.size() != static_cast<size_t>(num_keys)) {
+        throw TestException("Wrong number of entries");
+    }
+    std::cout << "Entries: " << count << ", memory usage: " << table.memory_usage() << " bytes" << std::endl;
+}
+
+int main() {
+    try {
+        std::cout << "Testing single thread operations..." << std::endl;
+        test_single_thread();
+
+        std::cout << "\nTesting custom comparator..." << std::endl;
+        test_custom_comparator();
+
+        std::cout << "\nTesting concurrent readers with one writer..." << std::endl;
+        test_concurrent_readers();
+
+        std::cout << "\nAll tests passed successfully!" << std::endl;
+        return 0;
+    } catch (const TestException& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
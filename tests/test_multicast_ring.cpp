@@ -0,0 +1,181 @@
+#include "../include/multithreaded_ds/multicast_ring.hpp"
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <stdexcept>
+
+class TestException : public std::runtime_error {
+public:
+    TestException(const std::string& message) : std::runtime_error(message) {}
+};
+
+struct event {
+    int64_t value = 0;
+    // written by the first pipeline stage, read by the second
+    int64_t doubled = 0;
+};
+
+template <typename Wait>
+void test_multicast() {
+    const int64_t num_events = 200000;
+    const int num_consumers = 3;
+    using ring_type = multithreaded_ds::multicast_ring<event, multithreaded_ds::single_producer, Wait>;
+    ring_type ring(1024);
+    std::vector<typename ring_type::consumer*> consumers;
+    for (int i = 0; i < num_consumers; ++i) {
+        consumers.push_back(&ring.add_consumer());
+    }
+
+    std::vector<int64_t> sums(num_consumers, 0);
+    std::atomic<bool> out_of_order{false};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_consumers; ++i) {
+        threads.emplace_back([&, i]() {
+            int64_t expected = 0;
+            while (expected < num_events) {
+                ring.consume(*consumers[i], [&](event& e, int64_t seq, bool) {
+                    if (e.value != seq || seq != expected) {
+                        out_of_order = true;
+                    }
+                    ++expected;
+                    sums[i] += e.value;
+                });
+            }
+        });
+    }
+
+    // mix single and batched publishes
+    for (int64_t i = 0; i < num_events;) {
+        size_t batch = static_cast<size_t>(std::min<int64_t>(1 + i % 16, num_events - i));
+        ring.publish_events(batch, [](event& e, int64_t seq) { e.value = seq; });
+        i += static_cast<int64_t>(batch);
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    if (out_of_order) {
+        throw TestException("Consumer saw events out of order");
+    }
+    for (auto s : sums) {
+        if (s != num_events * (num_events - 1) / 2) {
+            throw TestException("Consumer missed events");
+        }
+    }
+}
+
+void test_pipeline() {
+    const int64_t num_events = 100000;
+    multithreaded_ds::multicast_ring<event> ring(256);
+    auto& stage_a = ring.add_consumer();
+    auto& stage_b = ring.add_consumer({&stage_a});
+    std::atomic<bool> broken{false};
+
+    std::thread a([&]() {
+        int64_t seen = 0;
+        while (seen < num_events) {
+            seen += ring.consume(stage_a, [](event& e, int64_t, bool) { e.doubled = e.value * 2; });
+        }
+    });
+    std::thread b([&]() {
+        int64_t seen = 0;
+        while (seen < num_events) {
+            seen += ring.consume(stage_b, [&](event& e, int64_t, bool) {
+                if (e.doubled != e.value * 2) {
+                    broken = true;
+                }
+            });
+        }
+    });
+
+    for (int64_t i = 0; i < num_events; ++i) {
+        ring.publish_event([i](event& e, int64_t) { e.value = i + 1; e.doubled = 0; });
+    }
+    a.join();
+    b.join();
+
+    if (broken) {
+        throw TestException("Stage B overtook stage A");
+    }
+}
+
+void test_multi_producer() {
+    const int num_producers = 4;
+    const int64_t per_producer = 50000;
+    multithreaded_ds::multicast_ring<event, multithreaded_ds::multi_producer, multithreaded_ds::yielding_wait> ring(512);
+    auto& first = ring.add_consumer();
+    auto& second = ring.add_consumer();
+    const int64_t total = num_producers * per_producer;
+
+    std::vector<int64_t> sums(2, 0);
+    std::vector<std::thread> threads;
+    int index = 0;
+    for (auto c : {&first, &second}) {
+        threads.emplace_back([&, c, index]() {
+            int64_t seen = 0;
+            while (seen < total) {
+                seen += ring.consume(*c, [&](event& e, int64_t, bool) { sums[index] += e.value; });
+            }
+        });
+        ++index;
+    }
+    for (int p = 0; p < num_producers; ++p) {
+        threads.emplace_back([&, p]() {
+            // values 1..total, each published exactly once
+            int64_t next = p * per_producer;
+            for (int64_t i = 0; i < per_producer; i += 10) {
+                ring.publish_events(10, [&next](event& e, int64_t) { e.value = ++next; });
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    if (sums[0] != total * (total + 1) / 2 || sums[1] != sums[0]) {
+        throw TestException("Consumer missed or duplicated events");
+    }
+}
+
+void test_halt() {
+    multithreaded_ds::multicast_ring<event> ring(16);
+    auto& c = ring.add_consumer();
+    std::thread waiter([&]() {
+        if (ring.consume(c, [](event&, int64_t, bool) {}) != 0) {
+            throw TestException("Consumed an event that was never published");
+        }
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ring.halt();
+    waiter.join();
+    if (ring.try_consume(c, [](event&, int64_t, bool) {}) != 0) {
+        throw TestException("Empty ring produced an event");
+    }
+}
+
+int main() {
+    try {
+        std::cout << "Testing multicast with blocking wait..." << std::endl;
+        test_multicast<multithreaded_ds::blocking_wait>();
+
+        std::cout << "\nTesting multicast with yielding wait..." << std::endl;
+        test_multicast<multithreaded_ds::yielding_wait>();
+
+        std::cout << "\nTesting consumer pipeline..." << std::endl;
+        test_pipeline();
+
+        std::cout << "\nTesting multiple producers..." << std::endl;
+        test_multi_producer();
+
+        std::cout << "\nTesting halt..." << std::endl;
+        test_halt();
+
+        std::cout << "\nAll tests passed successfully!" << std::endl;
+        return 0;
+    } catch (const TestException& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,138 @@
+#include "../include/multithreaded_ds/object_pool.hpp"
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <stdexcept>
+
+class TestException : public std::runtime_error {
+public:
+    TestException(const std::string& message) : std::runtime_error(message) {}
+};
+
+std::atomic<int> live_requests{0};
+
+struct request {
+    uint64_t id;
+    std::string path;
+    char body[96];
+
+    request(uint64_t i, std::string p) : id(i), path(std::move(p)) { live_requests++; }
+    ~request() { live_requests--; }
+};
+
+struct alignas(64) aligned_block {
+    char data[8];
+};
+
+void test_single_thread() {
+    multithreaded_ds::object_pool<request> pool(2);
+
+    {
+        auto r = pool.make(7, "/index.html");
+        if (r->id != 7 || r->path != "/index.html" || live_requests != 1) {
+            throw TestException("Object not constructed in the pool");
+        }
+    }
+    if (live_requests != 0) {
+        throw TestException("Handle did not destroy its object");
+    }
+
+    // Freed blocks are reused LIFO from the magazine
+    void* first = pool.allocate();
+    pool.deallocate(first);
+    if (pool.allocate() != first) {
+        throw TestException("Magazine did not hand back the last freed block");
+    }
+
+    multithreaded_ds::object_pool<aligned_block> aligned;
+    for (int i = 0; i < 200; ++i) {
+        auto b = aligned.make();
+        if (reinterpret_cast<uintptr_t>(b.get()) % alignof(aligned_block) != 0) {
+            throw TestException("Block not aligned for its type");
+        }
+    }
+
+    // Small blocks near the end of a slab page map back to the right slab
+    using small_pool = multithreaded_ds::object_pool<uint64_t>;
+    small_pool small(1);
+    std::vector<small_pool::handle> values;
+    for (int i = 0; i < 2000; ++i) {
+        values.push_back(small.make(i));
+    }
+    for (int i = 0; i < 2000; ++i) {
+        char* p = reinterpret_cast<char*>(values[i].get());
+        char* page = reinterpret_cast<char*>(multithreaded_ds::slab::owner(p)) + sizeof(multithreaded_ds::slab);
+        if (*values[i] != static_cast<uint64_t>(i) || p < page ||
+            p + small_pool::block_size > page + multithreaded_ds::slab::page_size ||
+            multithreaded_ds::slab::owner(p)->block_size() != small_pool::block_size) {
+            throw TestException("Block does not map back to its slab");
+        }
+    }
+    values.clear();
+    small.trim();
+    // everything but the two magazines of the only cache slot goes back
+    auto s = small.stats();
+    if (multithreaded_ds::stats::enabled && s.slab_frees < 2000 - 2 * 32) {
+        throw TestException("trim() did not return blocks to their slabs");
+    }
+}
+
+void test_multi_thread_churn() {
+    multithreaded_ds::object_pool<request> pool(4);
+    const int num_threads = 8;
+    const int rounds = 20000;
+    std::vector<std::thread> threads;
+
+    // Objects are created on one thread and often released on another
+    std::vector<std::vector<multithreaded_ds::object_pool<request>::handle>> handoff(num_threads);
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&pool, &handoff, i]() {
+            std::vector<multithreaded_ds::object_pool<request>::handle> live;
+            for (int j = 0; j < rounds; ++j) {
+                live.push_back(pool.make(j, "/"));
+                if (live.size() > 64) {
+                    live.erase(live.begin(), live.begin() + 32);
+                }
+            }
+            handoff[i] = std::move(live);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    threads.clear();
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&handoff, i]() {
+            handoff[(i + 1) % num_threads].clear();
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (live_requests != 0) {
+        throw TestException("Objects leaked after churn");
+    }
+    auto s = pool.stats();
+    std::cout << "Allocations: " << s.allocations << ", depot exchanges: " << s.depot_exchanges
+              << ", slab allocations: " << s.slab_allocations << std::endl;
+}
+
+int main() {
+    try {
+        std::cout << "Testing single thread operations..." << std::endl;
+        test_single_thread();
+
+        std::cout << "\nTesting multi-thread churn..." << std::endl;
+        test_multi_thread_churn();
+
+        std::cout << "\nAll tests passed successfully!" << std::endl;
+        return 0;
+    } catch (const TestException& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
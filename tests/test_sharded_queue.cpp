@@ -0,0 +1,134 @@
+#include "../include/multithreaded_ds/sharded_queue.hpp"
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+
+class TestException : public std::runtime_error {
+public:
+    TestException(const std::string& message) : std::runtime_error(message) {}
+};
+
+void test_single_thread() {
+    multithreaded_ds::sharded_queue<int> queue(4);
+
+    for (int i = 0; i < 100; ++i) {
+        queue.push(i);
+    }
+    if (queue.size() != 100) {
+        throw TestException("Unexpected size after pushes");
+    }
+
+    // A single producer keeps FIFO order
+    int value;
+    for (int i = 0; i < 100; ++i) {
+        if (!queue.try_pop(value) || value != i) {
+            throw TestException("Single producer order not preserved");
+        }
+    }
+    if (queue.try_pop(value)) {
+        throw TestException("Popped from an empty queue");
+    }
+}
+
+void test_per_producer_fifo() {
+    multithreaded_ds::sharded_queue<std::pair<int, int>> queue(4);
+    const int num_producers = 4;
+    const int num_consumers = 4;
+    const int elements_per_producer = 20000;
+    std::atomic<int> producers_done{0};
+    std::atomic<int> total_consumed{0};
+    std::atomic<bool> order_broken{false};
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < num_producers; ++i) {
+        threads.emplace_back([&queue, &producers_done, i]() {
+            for (int j = 0; j < elements_per_producer; ++j) {
+                queue.push({i, j});
+            }
+            producers_done++;
+        });
+    }
+
+    for (int i = 0; i < num_consumers; ++i) {
+        threads.emplace_back([&]() {
+            // Each consumer must see every producer's sequence increasing
+            std::vector<int> last_seen(num_producers, -1);
+            std::pair<int, int> batch[32];
+            while (true) {
+                size_t n = queue.pop_bulk(batch, 32);
+                if (n == 0) {
+                    if (producers_done == num_producers && queue.isEmpty()) break;
+                    std::this_thread::yield();
+                    continue;
+                }
+                for (size_t k = 0; k < n; ++k) {
+                    if (batch[k].second <= last_seen[batch[k].first]) {
+                        order_broken = true;
+                    }
+                    last_seen[batch[k].first] = batch[k].second;
+                }
+                total_consumed += static_cast<int>(n);
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (order_broken) {
+        throw TestException("Per-producer FIFO order violated");
+    }
+    if (total_consumed != num_producers * elements_per_producer) {
+        throw TestException("Lost or duplicated elements");
+    }
+
+    std::cout << "Total values consumed: " << total_consumed << std::endl;
+}
+
+// steals count elements, like pops, not batches
+void test_steal_stats() {
+    multithreaded_ds::sharded_queue<int> queue(2);
+    // two fresh threads take consecutive slots, so different lanes; one
+    // of them is the consumer's home lane, the other one is stolen from
+    for (int producer = 1; producer <= 2; ++producer) {
+        std::thread([&queue, producer]() {
+            for (int i = 0; i < 10 * producer; ++i) {
+                queue.push(i);
+            }
+        }).join();
+    }
+
+    int batch[32];
+    size_t total = queue.pop_bulk(batch, 32);
+    total += queue.pop_bulk(batch, 32);
+    auto s = queue.stats();
+    if (total != 30) {
+        throw TestException("Bulk pops missed elements");
+    }
+    if (multithreaded_ds::stats::enabled && s.steals != 10 && s.steals != 20) {
+        throw TestException("Steals not counted per element");
+    }
+}
+
+int main() {
+    try {
+        std::cout << "Testing single thread operations..." << std::endl;
+        test_single_thread();
+
+        std::cout << "\nTesting per-producer FIFO order..." << std::endl;
+        test_per_producer_fifo();
+
+        std::cout << "\nTesting steal statistics..." << std::endl;
+        test_steal_stats();
+
+        std::cout << "\nAll tests passed successfully!" << std::endl;
+        return 0;
+    } catch (const TestException& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
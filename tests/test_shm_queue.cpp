@@ -0,0 +1,265 @@
+#include "../include/multithreaded_ds/shm_queue.hpp"
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <stdexcept>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+class TestException : public std::runtime_error {
+public:
+    TestException(const std::string& message) : std::runtime_error(message) {}
+};
+
+struct message {
+    uint32_t producer;
+    uint32_t seq;
+    char text[56];
+};
+
+std::string queue_name(const char* tag) {
+    return "/mtds_test_" + std::string(tag) + "_" + std::to_string(getpid());
+}
+
+// runs body in a forked child, which exits with 0 on success
+template <typename F>
+pid_t spawn(F body) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        _exit(body() ? 0 : 1);
+    }
+    return pid;
+}
+
+void expect_child_ok(pid_t pid) {
+    int status = 0;
+    waitpid(pid, &status, 0);
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        throw TestException("Child process failed");
+    }
+}
+
+void test_spsc_across_fork() {
+    const uint32_t num_messages = 100000;
+    std::string name = queue_name("spsc");
+    auto queue = multithreaded_ds::shm_spsc_queue<message>::open(name.c_str(), 64);
+    if (!queue) {
+        throw TestException("Could not create shared queue");
+    }
+
+    pid_t child = spawn([&]() {
+        // a fresh mapping, most likely at another address
+        auto q = multithreaded_ds::shm_spsc_queue<message>::open(name.c_str(), 64);
+        if (!q) return false;
+        for (uint32_t i = 0; i < num_messages; ++i) {
+            message m{0, i, {}};
+            std::snprintf(m.text, sizeof(m.text), "msg %u", i);
+            if (!q->wait_push(m)) return false;
+        }
+        q->close();
+        return true;
+    });
+
+    uint32_t expected = 0;
+    message m;
+    while (queue->wait_pop(m)) {
+        char text[56];
+        std::snprintf(text, sizeof(text), "msg %u", expected);
+        if (m.seq != expected || std::strcmp(m.text, text) != 0) {
+            throw TestException("Message corrupted or out of order");
+        }
+        ++expected;
+    }
+    expect_child_ok(child);
+    multithreaded_ds::shm_spsc_queue<message>::unlink(name.c_str());
+    if (expected != num_messages) {
+        throw TestException("Lost messages: got " + std::to_string(expected));
+    }
+}
+
+void test_mpsc_across_fork() {
+    const uint32_t num_producers = 3;
+    const uint32_t per_producer = 50000;
+    std::string name = queue_name("mpsc");
+    auto queue = multithreaded_ds::shm_mpsc_queue<message>::open(name.c_str(), 256);
+    if (!queue) {
+        throw TestException("Could not create shared queue");
+    }
+
+    std::vector<pid_t> children;
+    for (uint32_t p = 0; p < num_producers; ++p) {
+        children.push_back(spawn([&, p]() {
+            auto q = multithreaded_ds::shm_mpsc_queue<message>::open(name.c_str(), 256);
+            if (!q) return false;
+            for (uint32_t i = 0; i < per_producer; ++i) {
+                if (!q->wait_push(message{p, i, {}})) return false;
+            }
+            return true;
+        }));
+    }
+
+    // zero-copy consumption, per-producer order must hold
+    std::vector<uint32_t> next(num_producers, 0);
+    bool in_order = true;
+    for (uint32_t received = 0; received < num_producers * per_producer;) {
+        if (queue->pop_with([&](const message& m) {
+                in_order &= m.producer < num_producers && m.seq == next[m.producer];
+                next[m.producer]++;
+            })) {
+            ++received;
+        } else {
+            message m;
+            if (!queue->wait_pop_for(m, std::chrono::seconds(10))) {
+                throw TestException("Producers stalled");
+            }
+            in_order &= m.seq == next[m.producer];
+            next[m.producer]++;
+            ++received;
+        }
+    }
+    for (auto pid : children) {
+        expect_child_ok(pid);
+    }
+    multithreaded_ds::shm_mpsc_queue<message>::unlink(name.c_str());
+    if (!in_order) {
+        throw TestException("Per-producer order violated");
+    }
+}
+
+void test_crashed_initializer() {
+    std::string name = queue_name("crash");
+    {
+        auto queue = multithreaded_ds::shm_spsc_queue<uint64_t>::open(name.c_str(), 16);
+        if (!queue || !queue->push(7)) {
+            throw TestException("Could not create shared queue");
+        }
+    }
+    // a process that has already exited
+    pid_t dead = fork();
+    if (dead == 0) {
+        _exit(0);
+    }
+    waitpid(dead, nullptr, 0);
+
+    // make the region look like `dead` crashed halfway through formatting it
+    int fd = shm_open(name.c_str(), O_RDWR, 0600);
+    auto* init = static_cast<std::atomic<uint64_t>*>(mmap(nullptr, 4096, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+    init->store((static_cast<uint64_t>(dead) << 2) | 1);
+    std::memset(reinterpret_cast<char*>(init) + sizeof(uint64_t), 0xff, 16);
+    munmap(init, 4096);
+    close(fd);
+
+    auto queue = multithreaded_ds::shm_spsc_queue<uint64_t>::open(name.c_str(), 16);
+    multithreaded_ds::shm_spsc_queue<uint64_t>::unlink(name.c_str());
+    if (!queue) {
+        throw TestException("Region abandoned by a crashed initializer was not recovered");
+    }
+    uint64_t v;
+    if (queue->pop(v) || !queue->push(1) || !queue->pop(v) || v != 1) {
+        throw TestException("Recovered queue not freshly formatted");
+    }
+}
+
+void test_timeout_and_mismatch() {
+    std::string name = queue_name("misc");
+    auto queue = multithreaded_ds::shm_spsc_queue<uint64_t>::open(name.c_str(), 4);
+    if (!queue || queue->capacity() != 4) {
+        throw TestException("Could not create shared queue");
+    }
+    if (multithreaded_ds::shm_spsc_queue<uint64_t>::open(name.c_str(), 1024)) {
+        throw TestException("Opened a queue with a different capacity");
+    }
+    for (uint64_t i = 0; i < 4; ++i) {
+        queue->push(i);
+    }
+    if (queue->push(4)) {
+        throw TestException("Pushed into a full queue");
+    }
+    uint64_t v;
+    for (uint64_t i = 0; i < 4; ++i) {
+        queue->pop(v);
+    }
+    auto start = std::chrono::steady_clock::now();
+    if (queue->wait_pop_for(v, std::chrono::milliseconds(20))) {
+        throw TestException("Popped from an empty queue");
+    }
+    if (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(20)) {
+        throw TestException("wait_pop_for returned early");
+    }
+    multithreaded_ds::shm_spsc_queue<uint64_t>::unlink(name.c_str());
+}
+
+// a push that claimed its slot before close() must still reach the consumer
+void test_close_during_push() {
+    std::string name = queue_name("close");
+    auto queue = multithreaded_ds::shm_mpsc_queue<uint64_t>::open(name.c_str(), 4);
+    if (!queue) {
+        throw TestException("Could not create shared queue");
+    }
+    std::atomic<bool> claimed{false};
+    std::atomic<bool> release{false};
+    bool accepted = false;
+    std::thread producer([&]() {
+        accepted = queue->push_with([&](uint64_t& v) {
+            claimed = true;
+            while (!release) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            v = 42;
+        });
+    });
+    while (!claimed) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    queue->close();
+    if (queue->push(7)) {
+        throw TestException("Pushed into a closed queue");
+    }
+    std::thread releaser([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        release = true;
+    });
+    uint64_t v = 0;
+    bool got = queue->wait_pop(v);
+    producer.join();
+    releaser.join();
+    if (!accepted || !got || v != 42) {
+        throw TestException("Message accepted before close was lost");
+    }
+    if (queue->wait_pop(v)) {
+        throw TestException("Popped from a closed, drained queue");
+    }
+    multithreaded_ds::shm_mpsc_queue<uint64_t>::unlink(name.c_str());
+}
+
+int main() {
+    try {
+        std::cout << "Testing SPSC queue across fork..." << std::endl;
+        test_spsc_across_fork();
+
+        std::cout << "\nTesting MPSC queue across fork..." << std::endl;
+        test_mpsc_across_fork();
+
+        std::cout << "\nTesting recovery from a crashed initializer..." << std::endl;
+        test_crashed_initializer();
+
+        std::cout << "\nTesting timeouts and layout checks..." << std::endl;
+        test_timeout_and_mismatch();
+
+        std::cout << "\nTesting close during a push..." << std::endl;
+        test_close_during_push();
+
+        std::cout << "\nAll tests passed successfully!" << std::endl;
+        return 0;
+    } catch (const TestException& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
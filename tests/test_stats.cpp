@@ -0,0 +1,120 @@
+#define MULTITHREADED_DS_ENABLE_STATS 1
+
+#include "../include/multithreaded_ds/concurrent_queue.hpp"
+#include "../include/multithreaded_ds/threads_pool.hpp"
+#include "../include/multithreaded_ds/slab_allocator.hpp"
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <stdexcept>
+
+class TestException : public std::runtime_error {
+public:
+    TestException(const std::string& message) : std::runtime_error(message) {}
+};
+
+void test_queue_stats() {
+    multithreaded_ds::concurrent_queue<int> queue;
+    std::vector<std::thread> threads;
+    const int num_threads = 4;
+    const int elements_per_thread = 1000;
+
+    for (int i = 0; i < num_threads; ++i) {
+        threads.emplace_back([&queue]() {
+            for (int j = 0; j < elements_per_thread; ++j) {
+                queue.push(j);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    int value;
+    for (int i = 0; i < 10; ++i) {
+        queue.pop(value);
+    }
+
+    auto s = queue.stats();
+    if (s.pushes != num_threads * elements_per_thread) {
+        throw TestException("Push counter does not match number of pushes");
+    }
+    if (s.pops != 10) {
+        throw TestException("Pop counter does not match number of pops");
+    }
+    if (s.max_depth != num_threads * elements_per_thread) {
+        throw TestException("Queue depth high-water mark is wrong");
+    }
+    if (s.lock_acquisitions < s.pushes + s.pops) {
+        throw TestException("Missing lock acquisitions");
+    }
+
+    std::cout << "Lock acquisitions: " << s.lock_acquisitions << std::endl;
+    std::cout << "Lock wait (ns): " << s.lock_wait_ns << std::endl;
+    std::cout << "Lock hold (ns): " << s.lock_hold_ns << std::endl;
+}
+
+void test_pool_stats() {
+    const int num_tasks = 100;
+    multithreaded_ds::thread_pool pool(4);
+    std::vector<std::future<int>> results;
+    for (int i = 0; i < num_tasks; ++i) {
+        results.push_back(pool.submit([](int x) { return x * 2; }, i));
+    }
+    for (auto& r : results) {
+        r.get();
+    }
+
+    auto s = pool.stats();
+    if (s.tasks_submitted != num_tasks) {
+        throw TestException("Submitted task counter is wrong");
+    }
+    if (s.max_queue_depth == 0) {
+        throw TestException("Task queue high-water mark was not recorded");
+    }
+
+    std::cout << "Tasks completed: " << s.tasks_completed << std::endl;
+    std::cout << "Task wait (ns): " << s.task_wait_ns << std::endl;
+    std::cout << "Task run (ns): " << s.task_run_ns << std::endl;
+}
+
+void test_slab_stats() {
+    multithreaded_ds::slab_allocator allocator(64);
+    std::vector<void*> blocks;
+    const int blocks_per_slab = multithreaded_ds::slab::page_size / 64;
+
+    for (int i = 0; i < blocks_per_slab * 3 + 1; ++i) {
+        blocks.push_back(allocator.allocate());
+    }
+    auto s = allocator.stats();
+    if (s.slabs_created != 4 || s.slabs_exhausted != 3 || s.slabs_local != 1) {
+        throw TestException("Slab counts after allocation are wrong");
+    }
+
+    for (auto p : blocks) {
+        allocator.deallocate(p);
+    }
+    s = allocator.stats();
+    if (s.slabs_global != 4 || s.slabs_local != 0 || s.slabs_exhausted != 0) {
+        throw TestException("Slab counts after deallocation are wrong");
+    }
+}
+
+int main() {
+    try {
+        std::cout << "Testing queue stats..." << std::endl;
+        test_queue_stats();
+
+        std::cout << "\nTesting thread pool stats..." << std::endl;
+        test_pool_stats();
+
+        std::cout << "\nTesting slab allocator stats..." << std::endl;
+        test_slab_stats();
+
+        std::cout << "\nAll tests passed successfully!" << std::endl;
+        return 0;
+    } catch (const TestException& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}
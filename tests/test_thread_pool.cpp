@@ -0,0 +1,431 @@
+#include "../include/multithreaded_ds/threads_pool.hpp"
+#include "../include/multithreaded_ds/timing_wheel.hpp"
+#include "../include/multithreaded_ds/task_group.hpp"
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <stdexcept>
+#include <system_error>
+#include <future>
+
+class TestException : public std::runtime_error {
+public:
+    TestException(const std::string& message) : std::runtime_error(message) {}
+};
+
+using namespace std::chrono_literals;
+
+void test_submit() {
+    multithreaded_ds::thread_pool pool(4);
+    std::vector<std::future<int>> results;
+    for (int i = 0; i < 100; ++i) {
+        results.push_back(pool.submit([](int x) { return x * x; }, i));
+    }
+    for (int i = 0; i < 100; ++i) {
+        if (results[i].get() != i * i) {
+            throw TestException("Wrong task result");
+        }
+    }
+}
+
+// drives the wheel by hand, every timer must fire exactly on its tick
+void test_timing_wheel() {
+    multithreaded_ds::timing_wheel wheel;
+    std::mt19937_64 rng(42);
+    const int num_timers = 20000;
+    std::vector<uint64_t> deadline(num_timers);
+    std::vector<uint64_t> fired_at(num_timers, 0);
+    std::vector<multithreaded_ds::timing_wheel::timer_id> ids(num_timers);
+    uint64_t now = 0;
+
+    for (int i = 0; i < num_timers; ++i) {
+        // spread over every level, including the far end of level 2
+        uint64_t delta = 1 + rng() % (uint64_t(1) << (8 * (1 + i % 3)));
+        deadline[i] = delta;
+        ids[i] = wheel.add(delta, 0, [&fired_at, &now, i]() { fired_at[i] = now; });
+    }
+    // cancel every tenth timer
+    for (int i = 0; i < num_timers; i += 10) {
+        if (!wheel.cancel(ids[i])) {
+            throw TestException("Pending timer could not be cancelled");
+        }
+    }
+    if (wheel.cancel(ids[0])) {
+        throw TestException("Timer cancelled twice");
+    }
+
+    std::vector<std::function<void()>> expired;
+    while (!wheel.empty()) {
+        now += 1 + rng() % 7;
+        wheel.advance(now, expired);
+        for (auto& f : expired) f();
+        expired.clear();
+    }
+    for (int i = 0; i < num_timers; ++i) {
+        if (i % 10 == 0) {
+            if (fired_at[i] != 0) {
+                throw TestException("Cancelled timer fired");
+            }
+        } else if (fired_at[i] < deadline[i] || fired_at[i] >= deadline[i] + 7) {
+            throw TestException("Timer fired on the wrong tick");
+        }
+    }
+    if (wheel.cancel(ids[1])) {
+        throw TestException("Fired timer reported as cancelled");
+    }
+
+    // periodic timer keeps firing until cancelled
+    int runs = 0;
+    auto id = wheel.add(now + 3, 3, [&runs]() { ++runs; });
+    wheel.advance(now + 30, expired);
+    if (expired.size() != 10) {
+        throw TestException("Periodic timer fired " + std::to_string(expired.size()) + " times");
+    }
+    if (!wheel.cancel(id) || !wheel.empty()) {
+        throw TestException("Periodic timer not cancelled");
+    }
+}
+
+// an idle wheel must not walk every tick it missed, one tick at a time
+// over 2^40 ticks would never finish
+void test_timing_wheel_idle() {
+    multithreaded_ds::timing_wheel wheel;
+    std::vector<std::function<void()>> expired;
+    const uint64_t idle = uint64_t(1) << 40;
+
+    int runs = 0;
+    wheel.add(5, 0, []() {});
+    wheel.advance(idle, expired);
+    if (expired.size() != 1 || wheel.now() != idle) {
+        throw TestException("Wheel did not skip the idle stretch");
+    }
+    expired.clear();
+
+    // a timer armed after the idle stretch counts from the current tick
+    wheel.skip_idle(2 * idle);
+    wheel.add(2 * idle + 3, 0, [&runs]() { ++runs; });
+    wheel.advance(2 * idle + 2, expired);
+    if (!expired.empty()) {
+        throw TestException("Timer fired early after an idle stretch");
+    }
+    wheel.advance(2 * idle + 3, expired);
+    for (auto& f : expired) f();
+    if (runs != 1) {
+        throw TestException("Timer armed after an idle stretch did not fire on time");
+    }
+}
+
+// a lone far timer is reached in a handful of jumps, not one per tick
+void test_timing_wheel_next_tick() {
+    multithreaded_ds::timing_wheel wheel;
+    std::vector<std::function<void()>> expired;
+    const uint64_t hour = 3600 * 1000;
+    uint64_t fired_at = 0;
+    wheel.add(hour, 0, [&]() { fired_at = wheel.now(); });
+    // a few near ones must still fire on their own ticks
+    for (uint64_t t : {3, 300, 70000}) {
+        wheel.add(t, 0, []() {});
+    }
+
+    int wakes = 0;
+    size_t fired = 0;
+    while (!wheel.empty()) {
+        uint64_t next = wheel.next_tick();
+        if (next <= wheel.now()) {
+            throw TestException("next_tick not in the future");
+        }
+        wheel.advance(next, expired);
+        for (auto& f : expired) f();
+        fired += expired.size();
+        expired.clear();
+        ++wakes;
+    }
+    if (fired != 4 || fired_at != hour) {
+        throw TestException("Timer missed its tick while jumping");
+    }
+    if (wakes > 16) {
+        throw TestException("Wheel woke " + std::to_string(wakes) + " times for 4 timers");
+    }
+    if (wheel.next_tick() != UINT64_MAX) {
+        throw TestException("Empty wheel reported a next tick");
+    }
+}
+
+void test_schedule_after() {
+    multithreaded_ds::thread_pool pool(2);
+    std::atomic<int> fired{0};
+    std::atomic<bool> early{false};
+    const int num_timers = 1000;
+
+    auto start = multithreaded_ds::thread_pool::clock::now();
+    for (int i = 0; i < num_timers; ++i) {
+        auto delay = std::chrono::milliseconds(i % 50);
+        pool.schedule_after(delay, [&, delay, start]() {
+            if (multithreaded_ds::thread_pool::clock::now() - start < delay) {
+                early = true;
+            }
+            fired++;
+        });
+    }
+    auto cancelled = pool.schedule_after(10s, [&]() { fired++; });
+    pool.schedule_at(std::chrono::system_clock::now() + 20ms, [&]() { fired++; });
+
+    while (fired < num_timers + 1) {
+        std::this_thread::sleep_for(1ms);
+    }
+    if (early) {
+        throw TestException("Timer fired before its deadline");
+    }
+    if (!pool.cancel(cancelled) || pool.cancel(cancelled)) {
+        throw TestException("Long timer not cancelled exactly once");
+    }
+
+    auto s = pool.stats();
+    std::cout << "Timers scheduled: " << s.timers_scheduled << ", fired: " << s.timers_fired
+              << ", cancelled: " << s.timers_cancelled << std::endl;
+}
+
+// the timer thread sleeps until a far timer; a nearer one must wake it
+void test_far_timer_wakeup() {
+    multithreaded_ds::thread_pool pool(1);
+    std::atomic<bool> near_fired{false};
+    auto far = pool.schedule_after(std::chrono::hours(1), []() {});
+    std::this_thread::sleep_for(20ms);
+    auto start = multithreaded_ds::thread_pool::clock::now();
+    pool.schedule_after(5ms, [&]() { near_fired = true; });
+    while (!near_fired && multithreaded_ds::thread_pool::clock::now() - start < 1s) {
+        std::this_thread::sleep_for(1ms);
+    }
+    if (!near_fired) {
+        throw TestException("Near timer stuck behind a far one");
+    }
+    pool.cancel(far);
+}
+
+void test_schedule_every() {
+    multithreaded_ds::thread_pool pool(2);
+    std::atomic<int> runs{0};
+    auto handle = pool.schedule_every(5ms, [&]() { runs++; });
+    while (runs < 5) {
+        std::this_thread::sleep_for(1ms);
+    }
+    if (!pool.cancel(handle)) {
+        throw TestException("Periodic timer not cancellable");
+    }
+    // let a run that was already queued finish
+    std::this_thread::sleep_for(20ms);
+    int seen = runs;
+    std::this_thread::sleep_for(30ms);
+    if (runs != seen) {
+        throw TestException("Periodic timer kept running after cancel");
+    }
+}
+
+// a throwing timer callback must not take the worker (or the process) down
+void test_timer_exception() {
+    multithreaded_ds::thread_pool pool(1);
+    std::atomic<int> runs{0};
+    pool.schedule_after(1ms, []() { throw std::runtime_error("timer failed"); });
+    auto handle = pool.schedule_every(2ms, [&]() {
+        runs++;
+        throw std::runtime_error("periodic timer failed");
+    });
+    while (runs < 3) {
+        std::this_thread::sleep_for(1ms);
+    }
+    pool.cancel(handle);
+    if (pool.submit([]() { return 7; }).get() != 7) {
+        throw TestException("Pool stopped working after a timer threw");
+    }
+    auto s = pool.stats();
+    if (multithreaded_ds::stats::enabled && s.timers_failed < 4) {
+        throw TestException("Failed timer runs not counted");
+    }
+    std::cout << "Timer runs failed: " << s.timers_failed << std::endl;
+}
+
+void test_task_group() {
+    multithreaded_ds::thread_pool pool(4);
+    std::atomic<int> sum{0};
+    {
+        multithreaded_ds::task_group group(pool);
+        for (int i = 1; i <= 100; ++i) {
+            group.run([&sum, i]() { sum += i; });
+        }
+        group.wait();
+    }
+    if (sum != 5050) {
+        throw TestException("task_group did not run every task");
+    }
+
+    // first exception is rethrown by wait and cancels the rest
+    multithreaded_ds::task_group failing(pool);
+    failing.run([]() { throw std::runtime_error("subtask failed"); });
+    bool caught = false;
+    try {
+        failing.wait();
+    } catch (const std::runtime_error&) {
+        caught = true;
+    }
+    if (!caught || !failing.is_cancelled()) {
+        throw TestException("task_group lost a task exception");
+    }
+}
+
+void test_task_group_cancel() {
+    multithreaded_ds::thread_pool pool(1);
+    std::atomic<bool> started{false};
+    std::atomic<bool> saw_stop{false};
+    std::atomic<int> ran{0};
+
+    multithreaded_ds::task_group group(pool);
+    // occupies the only worker until the group is cancelled
+    group.run([&](multithreaded_ds::stop_token token) {
+        started = true;
+        while (!token.stop_requested()) {
+            std::this_thread::sleep_for(1ms);
+        }
+        saw_stop = true;
+    });
+    for (int i = 0; i < 1000; ++i) {
+        group.run([&]() { ran++; });
+    }
+    while (!started) {
+        std::this_thread::sleep_for(1ms);
+    }
+    group.cancel();
+    group.wait();
+
+    if (!saw_stop || ran != 0) {
+        throw TestException("Cancelled tasks still ran");
+    }
+    std::cout << "Tasks cancelled: " << pool.stats().tasks_cancelled << std::endl;
+}
+
+void test_shutdown_now() {
+    multithreaded_ds::thread_pool pool(1);
+    std::atomic<bool> started{false};
+    std::atomic<int> ran{0};
+    multithreaded_ds::task_group group(pool);
+
+    auto blocker = pool.submit([&]() {
+        started = true;
+        auto token = pool.get_stop_token();
+        while (!token.stop_requested()) {
+            std::this_thread::sleep_for(1ms);
+        }
+    });
+    std::vector<std::future<void>> queued;
+    for (int i = 0; i < 100; ++i) {
+        queued.push_back(pool.submit([&]() { ran++; }));
+        group.run([&]() { ran++; });
+    }
+    while (!started) {
+        std::this_thread::sleep_for(1ms);
+    }
+
+    size_t discarded = pool.shutdown_now();
+    if (discarded != 200 || ran != 0) {
+        throw TestException("shutdown_now ran queued work");
+    }
+    blocker.get();
+    // the group completes even though its tasks never ran
+    group.wait();
+    if (!group.is_cancelled()) {
+        throw TestException("Group not cancelled by pool shutdown");
+    }
+    try {
+        queued[0].get();
+        throw TestException("Discarded task completed its future");
+    } catch (const std::future_error&) {
+    }
+    // nothing runs after shutdown, not even new submissions
+    pool.submit([&]() { ran++; });
+    if (pool.schedule_after(1ms, [&]() { ran++; }).valid()) {
+        throw TestException("Timer armed on a stopped pool");
+    }
+    std::this_thread::sleep_for(10ms);
+    if (ran != 0) {
+        throw TestException("Task ran after shutdown_now");
+    }
+}
+
+// load shedding from inside the pool: the calling worker is not joined
+void test_shutdown_now_from_task() {
+    multithreaded_ds::thread_pool pool(2);
+    std::atomic<int> ran{0};
+    std::promise<void> release;
+    auto gate = release.get_future().share();
+    // keeps the other worker busy and the queue non-empty
+    pool.submit([gate]() { gate.wait(); });
+    for (int i = 0; i < 10; ++i) {
+        pool.submit([&]() { ran++; });
+    }
+    auto discarded = pool.submit([&]() {
+        size_t res = pool.shutdown_now();
+        ran += 100;
+        return res;
+    });
+    std::this_thread::sleep_for(10ms);
+    release.set_value();
+    size_t res = 0;
+    try {
+        res = discarded.get();
+    } catch (const std::system_error& e) {
+        throw TestException(std::string("shutdown_now from a task threw: ") + e.what());
+    }
+    if (ran < 100 || res + (ran - 100) != 10) {
+        throw TestException("shutdown_now from a task misbehaved");
+    }
+}
+
+int main() {
+    try {
+        std::cout << "Testing submit..." << std::endl;
+        test_submit();
+
+        std::cout << "\nTesting timing wheel..." << std::endl;
+        test_timing_wheel();
+
+        std::cout << "\nTesting timing wheel after an idle stretch..." << std::endl;
+        test_timing_wheel_idle();
+
+        std::cout << "\nTesting timing wheel next_tick..." << std::endl;
+        test_timing_wheel_next_tick();
+
+        std::cout << "\nTesting schedule_after/schedule_at..." << std::endl;
+        test_schedule_after();
+
+        std::cout << "\nTesting a near timer behind a far one..." << std::endl;
+        test_far_timer_wakeup();
+
+        std::cout << "\nTesting schedule_every..." << std::endl;
+        test_schedule_every();
+
+        std::cout << "\nTesting throwing timer callbacks..." << std::endl;
+        test_timer_exception();
+
+        std::cout << "\nTesting task_group..." << std::endl;
+        test_task_group();
+
+        std::cout << "\nTesting task_group cancellation..." << std::endl;
+        test_task_group_cancel();
+
+        std::cout << "\nTesting shutdown_now..." << std::endl;
+        test_shutdown_now();
+
+        std::cout << "\nTesting shutdown_now from a task..." << std::endl;
+        test_shutdown_now_from_task();
+
+        std::cout << "\nAll tests passed successfully!" << std::endl;
+        return 0;
+    } catch (const TestException& e) {
+        std::cerr << "Test failed: " << e.what() << std::endl;
+        return 1;
+    }
+}